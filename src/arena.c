@@ -0,0 +1,107 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc and free.
+#include "arena.h"
+
+// Every allocation is rounded up to this, enough for any type used here.
+#define ARENA_ALIGNMENT 16
+
+static ArenaBlock * create_block(size_t size);
+
+bool arena_init(Arena *arena, size_t block_size)
+{
+    arena -> block_size = block_size;
+    arena -> bytes_used = 0;
+    arena -> first = arena -> current = create_block(block_size);
+    if (arena -> first == NULL)
+    {
+        arena -> bytes_reserved = 0;
+        return false;
+    }
+
+    arena -> bytes_reserved = block_size;
+    return true;
+}
+
+void * arena_alloc(Arena *arena, size_t size)
+{
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    ArenaBlock *block = arena -> current;
+
+    if (block -> used + size > block -> size)
+    {
+        // Blocks after current are leftovers of a previous reset, reuse
+        // them before asking for more memory.
+        if (block -> next != NULL && block -> next -> size >= size)
+        {
+            block = block -> next;
+            block -> used = 0;
+        }
+
+        else
+        {
+            size_t block_size = size > arena -> block_size ?
+                                    size : arena -> block_size;
+
+            ArenaBlock *new_block = create_block(block_size);
+            if (new_block == NULL)
+            {
+                return NULL;
+            }
+
+            new_block -> next = block -> next;
+            block -> next = new_block;
+            block = new_block;
+            arena -> bytes_reserved += block_size;
+        }
+
+        arena -> current = block;
+    }
+
+    void *ptr = block -> data + block -> used;
+    block -> used += size;
+    arena -> bytes_used += size;
+    return ptr;
+}
+
+// O(1), only the first block is rewound, the others are rewound lazily once
+// arena_alloc() reaches them.
+void arena_reset(Arena *arena)
+{
+    arena -> current = arena -> first;
+    arena -> first -> used = 0;
+    arena -> bytes_used = 0;
+}
+
+void arena_free(Arena *arena)
+{
+    ArenaBlock *block = arena -> first;
+    while (block != NULL)
+    {
+        ArenaBlock *next = block -> next;
+        free(block);
+        block = next;
+    }
+
+    arena -> first = arena -> current = NULL;
+    arena -> bytes_used = arena -> bytes_reserved = 0;
+}
+
+// Header and data share a single malloc, data starts aligned right after it.
+static ArenaBlock * create_block(size_t size)
+{
+    size_t header = (sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) &
+                        ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    ArenaBlock *block = malloc(header + size);
+    if (block == NULL)
+    {
+        perror("Failed to allocate memory for arena block\n");
+        return NULL;
+    }
+
+    block -> next = NULL;
+    block -> size = size;
+    block -> used = 0;
+    block -> data = (unsigned char *)block + header;
+    return block;
+}
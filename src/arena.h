@@ -0,0 +1,32 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+
+// Bump allocator made of a chain of blocks, everything allocated from it is
+// released at once with arena_reset() (memory is kept for reuse) or
+// arena_free() (memory is given back to the system).
+typedef struct ArenaBlock
+{
+    struct ArenaBlock *next;
+    size_t size;                // Usable bytes of data.
+    size_t used;
+    unsigned char *data;
+} ArenaBlock;
+
+typedef struct Arena
+{
+    ArenaBlock *first;
+    ArenaBlock *current;
+    size_t block_size;          // Minimum size of each new block.
+    size_t bytes_used;          // Bytes handed out since last reset.
+    size_t bytes_reserved;      // Bytes obtained from malloc.
+} Arena;
+
+bool arena_init(Arena *arena, size_t block_size);
+void * arena_alloc(Arena *arena, size_t size);
+void arena_reset(Arena *arena);
+void arena_free(Arena *arena);
+
+#endif // ARENA_H
@@ -0,0 +1,220 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // llabs.
+#include "astar.h"
+
+static int64_t heuristic(const Maze *maze, int32_t x, int32_t y);
+static void jump_successors(
+        Tree *node, NodeHeap *open,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node);
+
+static bool jump(
+        const Maze *maze, int32_t x, int32_t y, int32_t dx, int32_t dy,
+        int32_t *jump_x, int32_t *jump_y);
+
+static inline bool walkable(const Maze *maze, int32_t x, int32_t y);
+
+bool best_first_init(NodeHeap *open, Tree *root, const Maze *maze)
+{
+    if (!heap_init(open))
+    {
+        return false;
+    }
+
+    heap_push(open, root, root -> distance_runned +
+            heuristic(maze, root -> head_x, root -> head_y));
+    return true;
+}
+
+// Returns true if atleast one node was expanded.
+bool astar_step(
+        NodeHeap *open, Frontier *children,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node)
+{
+    size_t expansions = open -> count;
+    for (size_t i = 0; i < expansions && !*end_reached; i++)
+    {
+        Tree *node = heap_pop(open);
+        enum MOVE_STATES result = move_node(
+                node, arena, maze, children, dirty);
+
+        for (size_t child = 0; child < children -> next_heads_count; child++)
+        {
+            Tree *next = children -> next_heads[child];
+            heap_push(open, next, next -> distance_runned +
+                    heuristic(maze, next -> head_x, next -> head_y));
+        }
+
+        children -> next_heads_count = 0;
+        if (result == NODE_END_REACHED)
+        {
+            *end_reached = true;
+            *winner_node = node;
+        }
+    }
+
+    return expansions > 0;
+}
+
+bool jps_step(
+        NodeHeap *open,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node)
+{
+    size_t expansions = open -> count;
+    for (size_t i = 0; i < expansions && !*end_reached; i++)
+    {
+        jump_successors(heap_pop(open), open,
+                arena, maze, dirty, end_reached, winner_node);
+    }
+
+    return expansions > 0;
+}
+
+static int64_t heuristic(const Maze *maze, int32_t x, int32_t y)
+{
+    return llabs((int64_t)maze -> end_x - x) +
+        llabs((int64_t)maze -> end_y - y);
+}
+
+// Jumps from node in every direction but the one it came from, the root
+// jumps in all of them. Moves are tried in the same order as move_node().
+// When END is reached a node is also made on the cell before it, so the walk
+// of the winner path starts next to END as with the other solvers.
+static void jump_successors(
+        Tree *node, NodeHeap *open,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node)
+{
+    enum MAZE_MOVES moves[] = {LEFT, UP, DOWN, RIGHT};
+    size_t move_quantity = sizeof(moves) / sizeof(enum MAZE_MOVES);
+    int32_t x = node -> head_x;
+    int32_t y = node -> head_y;
+    size_t head = maze_index(maze, x, y);
+    enum MAZE_MOVES came_from = NONE;
+    if (node -> parent != NULL)
+    {
+        int32_t px = node -> parent -> head_x;
+        int32_t py = node -> parent -> head_y;
+        came_from = px < x ? LEFT : px > x ? RIGHT : py < y ? UP : DOWN;
+    }
+
+    paint_cell(maze, dirty, head, DEAD_HEAD, node -> distance_runned);
+    for (size_t move = 0; move < move_quantity; move++)
+    {
+        if (moves[move] == came_from)
+        {
+            continue;
+        }
+
+        int32_t dx = moves[move] == LEFT ? -1 : moves[move] == RIGHT ? 1 : 0;
+        int32_t dy = moves[move] == UP ? -1 : moves[move] == DOWN ? 1 : 0;
+        int32_t tx, ty;
+        if (!jump(maze, x, y, dx, dy, &tx, &ty))
+        {
+            continue;
+        }
+
+        size_t target = maze_index(maze, tx, ty);
+        bool is_end = tx == maze -> end_x && ty == maze -> end_y;
+        if (maze -> types[target] != EMPTY && !is_end)
+        {
+            continue;
+        }
+
+        int64_t length = llabs((int64_t)tx - x) + llabs((int64_t)ty - y);
+        for (int64_t step = 1; step < length; step++)
+        {
+            size_t cell = maze_index(maze, x + dx * step, y + dy * step);
+            if (maze -> types[cell] == EMPTY)
+            {
+                paint_cell(maze, dirty, cell, BODY,
+                        node -> distance_runned + step);
+            }
+        }
+
+        Tree *parent = node;
+        if (is_end && length > 1)
+        {
+            parent = add_child(node, moves[move], tx - dx, ty - dy,
+                    node -> distance_runned + length - 1, arena);
+        }
+
+        Tree *child = add_child(parent, moves[move], tx, ty,
+                node -> distance_runned + length, arena);
+
+        paint_cell(maze, dirty, head, BODY, node -> distance_runned);
+        paint_cell(maze, dirty, target, LIVE_HEAD, child -> distance_runned);
+        if (is_end && !*end_reached)
+        {
+            *end_reached = true;
+            *winner_node = parent;
+        }
+
+        else if (!is_end)
+        {
+            heap_push(open, child, child -> distance_runned +
+                    heuristic(maze, tx, ty));
+        }
+    }
+}
+
+// Follows (dx, dy) from (x, y) until a cell where the path can turn or fork
+// (a forced neighbour) or END, false if a wall comes first.
+// Moving vertically also stops where a horizontal jump would find something,
+// horizontal runs are never cut short by vertical ones.
+static bool jump(
+        const Maze *maze, int32_t x, int32_t y, int32_t dx, int32_t dy,
+        int32_t *jump_x, int32_t *jump_y)
+{
+    while (true)
+    {
+        x += dx;
+        y += dy;
+        if (!walkable(maze, x, y))
+        {
+            return false;
+        }
+
+        *jump_x = x;
+        *jump_y = y;
+        if (x == maze -> end_x && y == maze -> end_y)
+        {
+            return true;
+        }
+
+        if (dx != 0)
+        {
+            if ((walkable(maze, x, y - 1) && !walkable(maze, x - dx, y - 1)) ||
+                (walkable(maze, x, y + 1) && !walkable(maze, x - dx, y + 1)))
+            {
+                return true;
+            }
+        }
+
+        else
+        {
+            if ((walkable(maze, x - 1, y) && !walkable(maze, x - 1, y - dy)) ||
+                (walkable(maze, x + 1, y) && !walkable(maze, x + 1, y - dy)))
+            {
+                return true;
+            }
+
+            int32_t side_x, side_y;
+            if (jump(maze, x, y, 1, 0, &side_x, &side_y) ||
+                jump(maze, x, y, -1, 0, &side_x, &side_y))
+            {
+                *jump_x = x;
+                *jump_y = y;
+                return true;
+            }
+        }
+    }
+}
+
+static inline bool walkable(const Maze *maze, int32_t x, int32_t y)
+{
+    return x >= 0 && y >= 0 && x < maze -> columns && y < maze -> rows &&
+        maze -> types[maze_index(maze, x, y)] != WALL;
+}
@@ -0,0 +1,36 @@
+#ifndef ASTAR_H
+#define ASTAR_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include "arena.h"      // Arena, bump allocator for the nodes of the tree.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // Tree, Frontier and DirtyCells.
+#include "heap.h"       // NodeHeap, open nodes by cost.
+
+// Best first solvers, the open node with the least distance runned plus the
+// manhattan distance to END is expanded first.
+// A step expands as many nodes as were open when it began, about a generation
+// of the forking solver, so every solver moves at a similar pace on screen.
+// Cells are claimed when their node is created, as move_node() does. That's
+// only optimal with a consistent heuristic if cells are never reached twice
+// through different paths, which is the case on a perfect maze.
+bool best_first_init(NodeHeap *open, Tree *root, const Maze *maze);
+
+// A*, children are made by move_node() into the next heads of children (its
+// heads aren't used) and then moved to the heap.
+bool astar_step(
+        NodeHeap *open, Frontier *children,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node);
+
+// Jump point search for 4-connected grids: nodes are only created where the
+// path can turn or fork, straight runs in between are jumped over and just
+// painted as BODY. A node and its parent are always on the same row or
+// column. Long corridors and open areas need far fewer nodes and heap
+// operations than A*.
+bool jps_step(
+        NodeHeap *open,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node);
+
+#endif // ASTAR_H
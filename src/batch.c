@@ -0,0 +1,273 @@
+// clock_gettime() and CLOCK_MONOTONIC aren't part of c99.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>      // printf and perror.
+#include <stdlib.h>     // malloc, calloc, free and qsort.
+#include <math.h>       // ceil.
+#include "batch.h"
+#include "platform.h"   // get_time_ms().
+
+// Rows of the report, in order.
+enum BATCH_MEASURES
+{
+    MEASURE_TOTAL,
+    MEASURE_LIVE_HEAD,
+    MEASURE_DEAD_HEAD,
+    MEASURE_DISTANCE,
+    MEASURE_GENERATIONS,
+    MEASURE_MAZE_MS,
+    MEASURE_SOLVE_MS,
+    BATCH_MEASURES_COUNT
+};
+
+static const char *measure_names[BATCH_MEASURES_COUNT] =
+{
+    [MEASURE_TOTAL] = "Total nodes:",
+    [MEASURE_LIVE_HEAD] = "Live head:",
+    [MEASURE_DEAD_HEAD] = "Dead head:",
+    [MEASURE_DISTANCE] = "Distance:",
+    [MEASURE_GENERATIONS] = "Generations:",
+    [MEASURE_MAZE_MS] = "Maze ms:",
+    [MEASURE_SOLVE_MS] = "Solve ms:",
+};
+
+static void * batch_worker(void *data);
+static double measure_value(
+        const BatchResult *result, enum BATCH_MEASURES measure);
+
+static void print_stats(const char *name, double *values, int64_t count);
+static double percentile(const double *sorted, int64_t count, double p);
+static int compare_values(const void *a, const void *b);
+
+// Runs the jobs until every maze is solved and its results filled.
+// False if a maze couldn't be made, the results are then incomplete.
+bool batch_run(Batch *batch, uint64_t seed)
+{
+    batch -> results = calloc(batch -> count, sizeof(BatchResult));
+    pthread_t *workers = malloc(sizeof(pthread_t) * batch -> jobs);
+    if (batch -> results == NULL || workers == NULL)
+    {
+        perror("Failed to allocate memory for batch\n");
+        free(workers);
+        batch_free(batch);
+        return false;
+    }
+
+    rng_seed(&batch -> rng, seed);
+    batch -> next = 0;
+    batch -> failed = false;
+    pthread_mutex_init(&batch -> lock, NULL);
+
+    double start = get_time_ms();
+    int32_t started = 0;
+    for (; started < batch -> jobs; started++)
+    {
+        if (pthread_create(&workers[started], NULL, batch_worker, batch) != 0)
+        {
+            perror("Failed to create batch thread\n");
+            break;
+        }
+    }
+
+    // The ones that started take the mazes of the ones that didn't.
+    for (int32_t worker = 0; worker < started; worker++)
+    {
+        pthread_join(workers[worker], NULL);
+    }
+
+    batch -> wall_ms = get_time_ms() - start;
+    pthread_mutex_destroy(&batch -> lock);
+    free(workers);
+    return started > 0 && !batch -> failed;
+}
+
+// min, mean, percentiles and max of every measure over the whole batch.
+void batch_report(const Batch *batch)
+{
+    int64_t count = batch -> count;
+    int64_t found = 0;
+    double *values = malloc(sizeof(double) * count);
+    if (values == NULL)
+    {
+        perror("Failed to allocate memory for batch report\n");
+        return;
+    }
+
+    for (int64_t maze = 0; maze < count; maze++)
+    {
+        found += batch -> results[maze].found;
+    }
+
+    printf("Batch:       %"PRId64" %s mazes of %"PRId32"x%"PRId32" solved "
+            "by %s on %"PRId32" jobs\n",
+            count, generator_name(batch -> generator),
+            batch -> rows, batch -> columns,
+            solver_name(batch -> solver), batch -> jobs);
+    printf("Found:       %"PRId64" of %"PRId64"\n", found, count);
+    printf("Wall time:   %.3f ms (%.1f mazes per second)\n",
+            batch -> wall_ms,
+            batch -> wall_ms > 0 ? count * 1000.0 / batch -> wall_ms : 0);
+    printf("%-13s %12s %12s %12s %12s %12s %12s\n",
+            "", "min", "mean", "p50", "p90", "p99", "max");
+
+    for (int32_t measure = 0; measure < BATCH_MEASURES_COUNT; measure++)
+    {
+        for (int64_t maze = 0; maze < count; maze++)
+        {
+            values[maze] = measure_value(&batch -> results[maze], measure);
+        }
+
+        print_stats(measure_names[measure], values, count);
+    }
+
+    free(values);
+}
+
+// Bytes batch_run() allocates for count mazes besides the ones of each job,
+// the results and the values batch_report() sorts.
+double batch_memory(int64_t count)
+{
+    return (double)count * (sizeof(BatchResult) + sizeof(double));
+}
+
+void batch_free(Batch *batch)
+{
+    free(batch -> results);
+    batch -> results = NULL;
+}
+
+// Takes the next maze until there are none left. The arena keeps its blocks
+// and the grid is carved again between mazes, so only the first maze of each
+// job pays for them.
+static void * batch_worker(void *data)
+{
+    Batch *batch = data;
+    Arena arena;
+    Maze *maze = NULL;
+    bool failed = false;
+    if (!arena_init(&arena, sizeof(Tree) * TREE_ARENA_BLOCK_NODES))
+    {
+        pthread_mutex_lock(&batch -> lock);
+        batch -> failed = true;
+        pthread_mutex_unlock(&batch -> lock);
+        return NULL;
+    }
+
+    while (!failed)
+    {
+        // Streams are split in the order the mazes are taken, so maze i
+        // gets the i-th one whichever job takes it.
+        pthread_mutex_lock(&batch -> lock);
+        int64_t index = batch -> next;
+        bool stop = batch -> failed || index == batch -> count;
+        Rng rng = stop ? batch -> rng : rng_split(&batch -> rng);
+        batch -> next += !stop;
+        pthread_mutex_unlock(&batch -> lock);
+
+        if (stop)
+        {
+            break;
+        }
+
+        BatchResult *result = &batch -> results[index];
+        arena_reset(&arena);
+
+        double start = get_time_ms();
+        bool carved = maze != NULL ?
+            generate_maze_on(maze, batch -> generator, &rng) :
+            (maze = generate_maze(batch -> generator,
+                                  batch -> rows, batch -> columns, &rng)) != NULL;
+        result -> maze_ms = get_time_ms() - start;
+
+        Tree *root = carved ? create_node(&arena) : NULL;
+        if (root == NULL)
+        {
+            failed = true;
+            break;
+        }
+
+        root -> head_x = maze -> start_x;
+        root -> head_y = maze -> start_y;
+
+        start = get_time_ms();
+        result -> found = find_path_headless(batch -> solver, root, &arena,
+                maze, batch -> threads, &result -> generations);
+        result -> solve_ms = get_time_ms() - start;
+
+        nodes_info(maze, &result -> total, &result -> live_head,
+                &result -> dead_head, &result -> distance);
+    }
+
+    if (failed)
+    {
+        pthread_mutex_lock(&batch -> lock);
+        batch -> failed = true;
+        pthread_mutex_unlock(&batch -> lock);
+    }
+
+    maze_free(maze);
+    arena_free(&arena);
+    return NULL;
+}
+
+static double measure_value(
+        const BatchResult *result, enum BATCH_MEASURES measure)
+{
+    switch (measure)
+    {
+        case MEASURE_TOTAL:
+            return result -> total;
+
+        case MEASURE_LIVE_HEAD:
+            return result -> live_head;
+
+        case MEASURE_DEAD_HEAD:
+            return result -> dead_head;
+
+        case MEASURE_DISTANCE:
+            return result -> distance;
+
+        case MEASURE_GENERATIONS:
+            return result -> generations;
+
+        case MEASURE_MAZE_MS:
+            return result -> maze_ms;
+
+        case MEASURE_SOLVE_MS:
+            return result -> solve_ms;
+
+        default:
+            return 0;
+    }
+}
+
+// A row of the report, values get sorted.
+static void print_stats(const char *name, double *values, int64_t count)
+{
+    double sum = 0;
+    for (int64_t i = 0; i < count; i++)
+    {
+        sum += values[i];
+    }
+
+    qsort(values, count, sizeof(double), compare_values);
+    printf("%-13s %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", name,
+            values[0], sum / count,
+            percentile(values, count, 50), percentile(values, count, 90),
+            percentile(values, count, 99), values[count - 1]);
+}
+
+// Nearest rank: the smallest value with at least p% of them at or below it.
+static double percentile(const double *sorted, int64_t count, double p)
+{
+    int64_t rank = ceil(p / 100.0 * count);
+    rank = rank < 1 ? 1 : rank > count ? count : rank;
+    return sorted[rank - 1];
+}
+
+static int compare_values(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
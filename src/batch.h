@@ -0,0 +1,54 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include <pthread.h>    // pthread_mutex_t.
+#include "rng.h"        // Rng, a stream per maze.
+#include "generator.h"  // Maze generators.
+#include "solvers.h"    // Solver strategies and find_path_headless().
+
+// What was measured on a maze of the batch, nodes and heads as nodes_info()
+// counts them.
+typedef struct BatchResult
+{
+    int64_t total;
+    int64_t live_head;
+    int64_t dead_head;
+    int64_t distance;
+    int64_t generations;
+    double maze_ms;
+    double solve_ms;
+    bool found;
+} BatchResult;
+
+// Generates and solves count mazes headless on a pool of threads, each with
+// its own arena and grid reused from maze to maze. Maze i is drawn from the
+// i-th rng_split() of the seed, so the results depend on the seed and not on
+// the jobs or on which thread took it.
+typedef struct Batch
+{
+    enum GENERATORS generator;
+    int32_t rows;
+    int32_t columns;
+    enum SOLVERS solver;
+    int32_t threads;            // Of each solve, see find_path_headless().
+    int64_t count;
+    int32_t jobs;
+    BatchResult *results;
+    double wall_ms;
+    pthread_mutex_t lock;
+
+    // Guarded by lock.
+    Rng rng;                    // Split for each maze as it's taken.
+    int64_t next;               // First maze not taken.
+    bool failed;
+} Batch;
+
+bool batch_run(Batch *batch, uint64_t seed);
+void batch_report(const Batch *batch);
+double batch_memory(int64_t count);
+void batch_free(Batch *batch);
+
+#endif // BATCH_H
@@ -0,0 +1,1123 @@
+// Benchmark driver, `make bench` runs it over the default matrix.
+// Each case (generator, solver, size, seed and threads) runs on a child
+// process so its peak memory is measured apart from the others, then every
+// stage of the case is printed as a CSV or JSON row:
+//  - generate:    generate_maze().
+//  - solve:       find_path_headless(), the solver loop without rendering.
+//  - fill_pixels: colors of every cell of the solved maze, CPU only.
+//  - draw_maze:   full repaint of the solved maze through the texture, it's
+//                 skipped if there's no video (SDL_VIDEODRIVER=offscreen
+//                 helps on machines without a display).
+// Stages repeat at least --repeats times and until --min_time is spent, the
+// median is the number to compare between runs.
+// --kernels benchmarks the grid kernels instead, against the scalar loops
+// they replaced, on a solved maze of each size:
+//  - init:    walls and carved cells of a new grid, maze_grid().
+//  - replace: VISITED cells back to EMPTY, end of recursive_backtracker().
+//  - count:   cells per type and highest distance, nodes_info().
+
+// fork, pipe and wait4 aren't part of c99.
+#define _DEFAULT_SOURCE
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stdio.h>      // printf and perror.
+#include <stdlib.h>     // malloc, free, qsort and strtol.
+#include <string.h>     // strcmp and strtok.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include <errno.h>      // global error variable "errno" and error macros.
+#include <argp.h>       // parsing of arguments on command line.
+#include <sys/resource.h>   // struct rusage, peak memory of the children.
+#include <sys/wait.h>   // wait4.
+#include <unistd.h>     // fork, pipe, read, write and close.
+#include "SDL.h"        // graphics.
+#include "arena.h"      // Arena, bump allocator for the nodes of the tree.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // Tree and create_node().
+#include "solvers.h"    // Solver strategies and find_path_headless().
+#include "generator.h"  // Maze generators.
+#include "render.h"     // Display and draw_maze().
+#include "rng.h"        // Rng, seedable random numbers.
+#include "platform.h"   // get_time_ms() and available_memory().
+#include "grid-kernels.h"   // Bulk kernels measured by --kernels.
+
+// Default argument values for the options on command line.
+#define DEFAULT_SIZES "63,255,1023,4095,16383"
+#define DEFAULT_SEEDS "1"
+#define DEFAULT_GENERATORS "backtracker"
+#define DEFAULT_SOLVERS "forking"
+#define DEFAULT_THREADS "1"
+#define DEFAULT_REPEATS 3
+#define DEFAULT_MIN_TIME 200
+#define DEFAULT_FORMAT_NAME csv
+// End of default values for options
+
+// Values per list option and repetitions per stage.
+#define BENCH_MAX_LIST 32
+#define BENCH_MAX_REPEATS 1000
+
+// Concatenate string with number, e.g "Pi is: " STR(3.14159)
+// on preprocessing.
+#define STR_HELPER(x) #x
+#define STR(x) STR_HELPER(x)
+
+enum SHORT_OPTION_KEYCODES
+{
+    OPTION_SIZES=777,
+    OPTION_SEEDS,
+    OPTION_GENERATORS,
+    OPTION_SOLVERS,
+    OPTION_THREADS,
+    OPTION_REPEATS,
+    OPTION_MIN_TIME,
+    OPTION_FORMAT,
+    OPTION_KERNELS,
+};
+
+enum BENCH_STAGES
+{
+    STAGE_GENERATE,
+    STAGE_SOLVE,
+    STAGE_FILL_PIXELS,
+    STAGE_DRAW_MAZE,
+    STAGES
+};
+
+enum BENCH_KERNELS
+{
+    KERNEL_INIT,
+    KERNEL_REPLACE,
+    KERNEL_COUNT,
+    KERNELS
+};
+
+enum BENCH_FORMATS {FORMAT_CSV, FORMAT_JSON};
+
+static const char *stage_names[STAGES] =
+{
+    [STAGE_GENERATE] = "generate",
+    [STAGE_SOLVE] = "solve",
+    [STAGE_FILL_PIXELS] = "fill_pixels",
+    [STAGE_DRAW_MAZE] = "draw_maze",
+};
+
+static const char *kernel_names[KERNELS] =
+{
+    [KERNEL_INIT] = "init",
+    [KERNEL_REPLACE] = "replace",
+    [KERNEL_COUNT] = "count",
+};
+
+typedef struct Arguments
+{
+    int32_t sizes[BENCH_MAX_LIST];
+    size_t sizes_count;
+    uint64_t seeds[BENCH_MAX_LIST];
+    size_t seeds_count;
+    enum GENERATORS generators[BENCH_MAX_LIST];
+    size_t generators_count;
+    enum SOLVERS solvers[BENCH_MAX_LIST];
+    size_t solvers_count;
+    int32_t threads[BENCH_MAX_LIST];
+    size_t threads_count;
+    int32_t repeats;
+    double min_time;
+    enum BENCH_FORMATS format;
+    bool kernels;
+} Arguments;
+
+// One combination of the matrix.
+typedef struct BenchCase
+{
+    enum GENERATORS generator;
+    enum SOLVERS solver;
+    int32_t size;
+    uint64_t seed;
+    int32_t threads;
+} BenchCase;
+
+// Written by the child through a pipe, ms are per repetition.
+typedef struct BenchTiming
+{
+    bool skipped;
+    int32_t repeats;
+    double min_ms;
+    double median_ms;
+    double mean_ms;
+} BenchTiming;
+
+// State shared by the repetitions of a stage.
+typedef struct BenchRun
+{
+    const BenchCase *bench;
+    Maze *solved;               // For fill_pixels and draw_maze.
+    Display display;
+    Maze *work;                 // Grid the kernels write, --kernels only.
+    const uint8_t *visited;     // Types restored before each replace.
+    bool loop;                  // Scalar loops instead of the kernels.
+    int64_t sink;               // Keeps the count results alive.
+} BenchRun;
+
+const char *argp_program_version =
+"maze-bench v1.0.0\n"
+"Copyright (C) 2024 Sivefunc\n"
+"License GPLv3+: GNU GPL version 3 or later"
+    "<https://gnu.org/licenses/gpl.html>\n"
+"This is free software: you are free to change and redistribute it.\n"
+"There is NO WARRANTY, to the extent permitted by law.\n";
+
+const char *argp_program_bug_address = "<sivefunc@tuta.io>";
+
+static struct argp_option options[] =
+{
+    {"help", 'h', 0, 0, "show this message.", -1},
+    {"version", 'v', 0, 0, "show version of program.", -1},
+    {"sizes", OPTION_SIZES, "LIST", 0,
+        "rows and columns of each maze, comma separated: "
+        DEFAULT_SIZES " by default.", 0},
+
+    {"seeds", OPTION_SEEDS, "LIST", 0,
+        "seeds, comma separated: " DEFAULT_SEEDS " by default.", 1},
+
+    {"generators", OPTION_GENERATORS, "LIST", 0,
+        "generators (backtracker, kruskal, wilson or eller), comma "
+        "separated: " DEFAULT_GENERATORS " by default.", 2},
+
+    {"solvers", OPTION_SOLVERS, "LIST", 0,
+        "solvers (forking, bidirectional, astar, jps, junctions, compact "
+        "or bitboard), comma separated: " DEFAULT_SOLVERS " by default.", 2},
+
+    {"threads", OPTION_THREADS, "LIST", 0,
+        "threads of the solver, comma separated: " DEFAULT_THREADS
+        " by default.", 3},
+
+    {"repeats", OPTION_REPEATS, "NUM", 0,
+        "minimum repetitions of each stage: " STR(DEFAULT_REPEATS)
+        " by default.", 4},
+
+    {"min_time", OPTION_MIN_TIME, "MS", 0,
+        "stages keep repeating until they took this long: "
+        STR(DEFAULT_MIN_TIME) " by default.", 5},
+
+    {"format", OPTION_FORMAT, "NAME", 0,
+        "csv or json: " STR(DEFAULT_FORMAT_NAME) " by default.", 6},
+
+    {"kernels", OPTION_KERNELS, 0, 0,
+        "benchmark the grid kernels against scalar loops on each size "
+        "instead, with the first generator, solver, seed and threads.", 7},
+
+    {0}
+};
+
+static error_t parse_opt(int32_t key, char *arg, struct argp_state *state);
+static bool set_list(Arguments *args, int32_t key, char *arg);
+static bool parse_generator(const char *name, enum GENERATORS *generator);
+static bool parse_solver(const char *name, enum SOLVERS *solver);
+
+static void run_case(const BenchCase *bench, const Arguments *args, int fd);
+static void repeat_stage(
+        BenchTiming *timing,
+        double (*stage)(BenchRun *run), BenchRun *run,
+        const Arguments *args);
+
+static double stage_generate(BenchRun *run);
+static double stage_solve(BenchRun *run);
+static double stage_fill_pixels(BenchRun *run);
+static double stage_draw_maze(BenchRun *run);
+static Maze * solved_maze(const BenchCase *bench);
+
+static void run_kernels(const Arguments *args);
+static double kernel_init(BenchRun *run);
+static double kernel_replace(BenchRun *run);
+static double kernel_count(BenchRun *run);
+static void loop_init(Maze *maze);
+static void loop_replace(Maze *maze);
+static int64_t loop_count(const Maze *maze);
+static bool open_display(Display *display, const Maze *maze);
+static void close_display(Display *display);
+static int compare_ms(const void *a, const void *b);
+
+static void print_header(const Arguments *args);
+static void print_row(
+        const Arguments *args, const BenchCase *bench,
+        enum BENCH_STAGES stage, const BenchTiming *timing,
+        long peak_kib, bool first);
+static void print_kernel_row(
+        const Arguments *args, enum BENCH_KERNELS kernel,
+        const char *implementation, int32_t size,
+        const BenchTiming *timing, bool first);
+static void print_footer(const Arguments *args);
+
+int32_t main(int32_t argc, char *argv[])
+{
+    struct argp argp =
+    {
+        options,
+        parse_opt,
+        0,
+        "Benchmarks of generation, solving and rendering\n\v"
+        "Written by Sivefunc",
+        0,
+        0,
+        0
+    };
+
+    Arguments args =
+    {
+        .repeats = DEFAULT_REPEATS,
+        .min_time = DEFAULT_MIN_TIME,
+        .format = FORMAT_CSV,
+    };
+
+    char sizes[] = DEFAULT_SIZES;
+    char seeds[] = DEFAULT_SEEDS;
+    char generators[] = DEFAULT_GENERATORS;
+    char solvers[] = DEFAULT_SOLVERS;
+    char threads[] = DEFAULT_THREADS;
+    set_list(&args, OPTION_SIZES, sizes);
+    set_list(&args, OPTION_SEEDS, seeds);
+    set_list(&args, OPTION_GENERATORS, generators);
+    set_list(&args, OPTION_SOLVERS, solvers);
+    set_list(&args, OPTION_THREADS, threads);
+    if (argp_parse(&argp, argc, argv, ARGP_NO_HELP, 0, &args) != 0)
+    {
+        return 1;
+    }
+
+    if (args.kernels)
+    {
+        run_kernels(&args);
+        return EXIT_SUCCESS;
+    }
+
+    print_header(&args);
+    bool first = true;
+    for (size_t g = 0; g < args.generators_count; g++)
+    for (size_t v = 0; v < args.solvers_count; v++)
+    for (size_t s = 0; s < args.sizes_count; s++)
+    for (size_t e = 0; e < args.seeds_count; e++)
+    for (size_t t = 0; t < args.threads_count; t++)
+    {
+        BenchCase bench =
+        {
+            .generator = args.generators[g],
+            .solver = args.solvers[v],
+            .size = args.sizes[s],
+            .seed = args.seeds[e],
+            .threads = args.threads[t],
+        };
+
+        BenchTiming timings[STAGES];
+        for (size_t stage = 0; stage < STAGES; stage++)
+        {
+            timings[stage].skipped = true;
+        }
+
+        // Cases that can't fit are reported as skipped instead of swapping.
+        int32_t odd = bench.size - (bench.size % 2 == 0);
+        double cells = (double)odd * odd;
+        double memory_needed = cells * (MAZE_BYTES_PER_CELL + sizeof(uint32_t))
+            + solver_memory(bench.solver, odd, odd);
+
+        double memory_available = available_memory();
+        long peak_kib = 0;
+        if (memory_available <= 0 || memory_needed < memory_available)
+        {
+            int fds[2];
+            if (pipe(fds) != 0)
+            {
+                perror("Failed to create pipe\n");
+                return 1;
+            }
+
+            fflush(stdout);
+            pid_t child = fork();
+            if (child < 0)
+            {
+                perror("Failed to fork\n");
+                return 1;
+            }
+
+            if (child == 0)
+            {
+                close(fds[0]);
+                run_case(&bench, &args, fds[1]);
+                close(fds[1]);
+                _exit(EXIT_SUCCESS);
+            }
+
+            close(fds[1]);
+            size_t received = 0;
+            while (received < sizeof(timings))
+            {
+                ssize_t bytes = read(fds[0],
+                        (char *)timings + received, sizeof(timings) - received);
+                if (bytes <= 0)
+                {
+                    break;
+                }
+
+                received += bytes;
+            }
+
+            close(fds[0]);
+            int status;
+            struct rusage usage;
+            wait4(child, &status, 0, &usage);
+            peak_kib = usage.ru_maxrss;
+
+            // A crashed child counts as every stage skipped.
+            if (received < sizeof(timings))
+            {
+                for (size_t stage = 0; stage < STAGES; stage++)
+                {
+                    timings[stage].skipped = true;
+                }
+            }
+        }
+
+        for (size_t stage = 0; stage < STAGES; stage++)
+        {
+            print_row(&args, &bench, stage, &timings[stage], peak_kib, first);
+            first = false;
+        }
+    }
+
+    print_footer(&args);
+    return EXIT_SUCCESS;
+}
+
+// Child process of a case, the timings of every stage go to fd.
+static void run_case(const BenchCase *bench, const Arguments *args, int fd)
+{
+    BenchTiming timings[STAGES];
+    BenchRun run = {.bench = bench, .solved = NULL};
+    repeat_stage(&timings[STAGE_GENERATE], stage_generate, &run, args);
+    repeat_stage(&timings[STAGE_SOLVE], stage_solve, &run, args);
+
+    run.solved = solved_maze(bench);
+    Display *display = &run.display;
+    memset(display, 0, sizeof(Display));
+    display -> show_body = true;
+    display -> show_dead_head = true;
+    bool colors = run.solved != NULL &&
+        gradient_init(&display -> gradient, GRADIENT_GREEN, run.solved);
+
+    timings[STAGE_FILL_PIXELS].skipped = true;
+    if (colors)
+    {
+        display -> pixels = malloc(sizeof(uint32_t) * maze_cells(run.solved));
+        if (display -> pixels != NULL)
+        {
+            repeat_stage(&timings[STAGE_FILL_PIXELS], stage_fill_pixels,
+                    &run, args);
+            free(display -> pixels);
+            display -> pixels = NULL;
+        }
+    }
+
+    timings[STAGE_DRAW_MAZE].skipped = true;
+    if (colors && open_display(display, run.solved))
+    {
+        repeat_stage(&timings[STAGE_DRAW_MAZE], stage_draw_maze, &run, args);
+        close_display(display);
+    }
+
+    if (colors)
+    {
+        gradient_free(&display -> gradient);
+    }
+
+    maze_free(run.solved);
+    if (write(fd, timings, sizeof(timings)) != sizeof(timings))
+    {
+        perror("Failed to send timings\n");
+    }
+}
+
+// Runs stage until it has been repeated enough, a negative time means the
+// stage can't run on this case.
+static void repeat_stage(
+        BenchTiming *timing,
+        double (*stage)(BenchRun *run), BenchRun *run,
+        const Arguments *args)
+{
+    static double times[BENCH_MAX_REPEATS];
+    double total = 0;
+    int32_t repeats = 0;
+    timing -> skipped = false;
+    while (repeats < BENCH_MAX_REPEATS &&
+            (repeats < args -> repeats || total < args -> min_time))
+    {
+        double ms = stage(run);
+        if (ms < 0)
+        {
+            timing -> skipped = true;
+            return;
+        }
+
+        times[repeats++] = ms;
+        total += ms;
+    }
+
+    qsort(times, repeats, sizeof(double), compare_ms);
+    timing -> repeats = repeats;
+    timing -> min_ms = times[0];
+    timing -> median_ms = repeats % 2 ? times[repeats / 2] :
+        (times[repeats / 2 - 1] + times[repeats / 2]) / 2;
+    timing -> mean_ms = total / repeats;
+}
+
+static double stage_generate(BenchRun *run)
+{
+    Rng rng;
+    rng_seed(&rng, run -> bench -> seed);
+
+    double start = get_time_ms();
+    Maze *maze = generate_maze(run -> bench -> generator,
+            run -> bench -> size, run -> bench -> size, &rng);
+    double ms = get_time_ms() - start;
+    if (maze == NULL)
+    {
+        return -1;
+    }
+
+    maze_free(maze);
+    return ms;
+}
+
+// Only the solver loop is timed, not the generation of its maze.
+static double stage_solve(BenchRun *run)
+{
+    Rng rng;
+    rng_seed(&rng, run -> bench -> seed);
+    Maze *maze = generate_maze(run -> bench -> generator,
+            run -> bench -> size, run -> bench -> size, &rng);
+
+    Arena arena;
+    if (maze == NULL ||
+            !arena_init(&arena, sizeof(Tree) * TREE_ARENA_BLOCK_NODES))
+    {
+        maze_free(maze);
+        return -1;
+    }
+
+    Tree *root = create_node(&arena);
+    if (root == NULL)
+    {
+        arena_free(&arena);
+        maze_free(maze);
+        return -1;
+    }
+
+    root -> head_x = maze -> start_x;
+    root -> head_y = maze -> start_y;
+
+    int64_t generations = 0;
+    double start = get_time_ms();
+    find_path_headless(run -> bench -> solver, root, &arena, maze,
+            run -> bench -> threads, &generations);
+    double ms = get_time_ms() - start;
+
+    arena_free(&arena);
+    maze_free(maze);
+    return ms;
+}
+
+static double stage_fill_pixels(BenchRun *run)
+{
+    double start = get_time_ms();
+    fill_pixels(&run -> display, run -> solved, run -> display.pixels,
+            run -> solved -> columns * sizeof(uint32_t));
+    return get_time_ms() - start;
+}
+
+static double stage_draw_maze(BenchRun *run)
+{
+    DirtyCells dirty = {.cells = NULL, .count = 0, .capacity = 0,
+                        .everything = true};
+
+    double start = get_time_ms();
+    draw_maze(&run -> display, run -> solved, &dirty);
+    SDL_RenderPresent(run -> display.renderer);
+    return get_time_ms() - start;
+}
+
+// The maze as it's left at the end of a run, with every kind of cell.
+static Maze * solved_maze(const BenchCase *bench)
+{
+    Rng rng;
+    rng_seed(&rng, bench -> seed);
+    Maze *maze = generate_maze(bench -> generator,
+            bench -> size, bench -> size, &rng);
+
+    Arena arena;
+    if (maze == NULL ||
+            !arena_init(&arena, sizeof(Tree) * TREE_ARENA_BLOCK_NODES))
+    {
+        maze_free(maze);
+        return NULL;
+    }
+
+    Tree *root = create_node(&arena);
+    if (root != NULL)
+    {
+        int64_t generations = 0;
+        root -> head_x = maze -> start_x;
+        root -> head_y = maze -> start_y;
+        find_path_headless(bench -> solver, root, &arena, maze,
+                bench -> threads, &generations);
+    }
+
+    arena_free(&arena);
+    return maze;
+}
+
+// Every kernel is measured with the scalar loops first and then with each
+// version the CPU supports, all on the same process since they barely
+// allocate.
+static void run_kernels(const Arguments *args)
+{
+    static double (*const kernels[KERNELS])(BenchRun *run) =
+    {
+        [KERNEL_INIT] = kernel_init,
+        [KERNEL_REPLACE] = kernel_replace,
+        [KERNEL_COUNT] = kernel_count,
+    };
+
+    print_header(args);
+    bool first = true;
+    for (size_t s = 0; s < args -> sizes_count; s++)
+    {
+        BenchCase bench =
+        {
+            .generator = args -> generators[0],
+            .solver = args -> solvers[0],
+            .size = args -> sizes[s],
+            .seed = args -> seeds[0],
+            .threads = args -> threads[0],
+        };
+
+        BenchRun run = {.bench = &bench, .solved = solved_maze(&bench)};
+        run.work = run.solved == NULL ? NULL : maze_clone(run.solved);
+        uint8_t *visited = run.work == NULL ? NULL :
+            malloc(maze_cells(run.work));
+
+        // Carved cells are VISITED when recursive_backtracker() finishes.
+        if (visited != NULL)
+        {
+            loop_init(run.work);
+            for (size_t cell = 0; cell < maze_cells(run.work); cell++)
+            {
+                bool carved = maze_index_x(run.work, cell) % 2 == 0 &&
+                    maze_index_y(run.work, cell) % 2 == 0;
+
+                visited[cell] = carved ? VISITED : run.work -> types[cell];
+            }
+        }
+
+        run.visited = visited;
+        for (enum BENCH_KERNELS kernel = KERNEL_INIT; kernel < KERNELS;
+                kernel++)
+        {
+            for (int32_t level = -1; level < GRID_KERNELS_COUNT; level++)
+            {
+                BenchTiming timing = {.skipped = true};
+                run.loop = level < 0;
+                if (!run.loop && !grid_kernels_use(level))
+                {
+                    continue;
+                }
+
+                if (visited != NULL)
+                {
+                    repeat_stage(&timing, kernels[kernel], &run, args);
+                }
+
+                print_kernel_row(args, kernel,
+                        run.loop ? "loop" : grid_kernels_name(level),
+                        bench.size, &timing, first);
+                first = false;
+            }
+        }
+
+        free(visited);
+        maze_free(run.work);
+        maze_free(run.solved);
+    }
+
+    print_footer(args);
+}
+
+static double kernel_init(BenchRun *run)
+{
+    double start = get_time_ms();
+    if (run -> loop)
+    {
+        loop_init(run -> work);
+    }
+
+    else
+    {
+        Maze *maze = run -> work;
+        for (int32_t row = 0; row < maze -> rows; row++)
+        {
+            uint8_t *cells = maze -> types + maze_index(maze, 0, row);
+            if (row % 2)
+            {
+                grid_fill(cells, maze -> columns, WALL);
+            }
+            else
+            {
+                grid_fill_alternating(cells, maze -> columns, EMPTY, WALL);
+            }
+        }
+    }
+
+    return get_time_ms() - start;
+}
+
+// Only the replace is timed, not putting the VISITED cells back.
+static double kernel_replace(BenchRun *run)
+{
+    Maze *maze = run -> work;
+    memcpy(maze -> types, run -> visited, maze_cells(maze));
+
+    double start = get_time_ms();
+    if (run -> loop)
+    {
+        loop_replace(maze);
+    }
+
+    else
+    {
+        grid_replace(maze -> types, maze_cells(maze), VISITED, EMPTY);
+    }
+
+    return get_time_ms() - start;
+}
+
+static double kernel_count(BenchRun *run)
+{
+    const Maze *maze = run -> solved;
+    double start = get_time_ms();
+    if (run -> loop)
+    {
+        run -> sink += loop_count(maze);
+    }
+
+    else
+    {
+        size_t counts[GRID_TYPES];
+        uint16_t tree_types = (uint16_t)~(1 << EMPTY | 1 << WALL | 1 << END);
+        grid_count(maze -> types, maze_cells(maze), counts);
+        run -> sink += counts[DEAD_HEAD] + counts[LIVE_HEAD] +
+            grid_max_distance(maze -> types, maze -> distances_runned,
+                    maze_cells(maze), tree_types);
+    }
+
+    return get_time_ms() - start;
+}
+
+// The loops the kernels replaced, as they were.
+static void loop_init(Maze *maze)
+{
+    size_t cell = 0;
+    for (int32_t row = 0; row < maze -> rows; row++)
+    {
+        for (int32_t column = 0; column < maze -> columns; column++, cell++)
+        {
+            maze -> types[cell] = row % 2 || column % 2 ? WALL : EMPTY;
+        }
+    }
+}
+
+static void loop_replace(Maze *maze)
+{
+    for (size_t cell = 0; cell < maze_cells(maze); cell++)
+    {
+        if (maze -> types[cell] == VISITED)
+        {
+            maze -> types[cell] = EMPTY;
+        }
+    }
+}
+
+static int64_t loop_count(const Maze *maze)
+{
+    int64_t total = 0, live_head = 0, dead_head = 0, distance_runned = 0;
+    for (size_t cell = 0; cell < maze_cells(maze); cell++)
+    {
+        uint8_t type = maze -> types[cell];
+        if (type == EMPTY || type == WALL || type == END)
+        {
+            continue;
+        }
+
+        total += 1;
+        if (type == DEAD_HEAD || type == END_DEAD_HEAD)
+        {
+            dead_head += 1;
+        }
+
+        else if(type == LIVE_HEAD || type == END_LIVE_HEAD)
+        {
+            live_head += 1;
+        }
+
+        if (maze -> distances_runned[cell] >= distance_runned)
+        {
+            distance_runned = maze -> distances_runned[cell];
+        }
+    }
+
+    return total + live_head + dead_head + distance_runned;
+}
+
+// Hidden window with the texture renderer, false if there's no video or the
+// maze doesn't fit on a texture.
+static bool open_display(Display *display, const Maze *maze)
+{
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        return false;
+    }
+
+    if (SDL_CreateWindowAndRenderer(640, 480, SDL_WINDOW_HIDDEN,
+                &display -> window, &display -> renderer) < 0)
+    {
+        SDL_Quit();
+        return false;
+    }
+
+    if (!create_texture(display, maze))
+    {
+        SDL_DestroyRenderer(display -> renderer);
+        SDL_DestroyWindow(display -> window);
+        SDL_Quit();
+        return false;
+    }
+
+    return true;
+}
+
+static void close_display(Display *display)
+{
+    SDL_DestroyTexture(display -> texture);
+    free(display -> pixels);
+    display -> texture = NULL;
+    display -> pixels = NULL;
+    SDL_DestroyRenderer(display -> renderer);
+    SDL_DestroyWindow(display -> window);
+    SDL_Quit();
+}
+
+static int compare_ms(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void print_header(const Arguments *args)
+{
+    if (args -> format == FORMAT_JSON)
+    {
+        printf("[\n");
+        return;
+    }
+
+    if (args -> kernels)
+    {
+        printf("kernel,implementation,rows,columns,repeats,min_ms,"
+               "median_ms,mean_ms,cells_per_second,status\n");
+        return;
+    }
+
+    printf("stage,generator,solver,rows,columns,seed,threads,repeats,"
+           "min_ms,median_ms,mean_ms,cells_per_second,peak_rss_kib,"
+           "status\n");
+}
+
+// Cells per second are of the median, peak memory is of the whole case.
+static void print_row(
+        const Arguments *args, const BenchCase *bench,
+        enum BENCH_STAGES stage, const BenchTiming *timing,
+        long peak_kib, bool first)
+{
+    int32_t odd = bench -> size - (bench -> size % 2 == 0);
+    double cells = (double)odd * odd;
+    double cells_per_second = timing -> skipped || timing -> median_ms <= 0 ?
+        0 : cells / (timing -> median_ms / 1000);
+
+    const char *status = timing -> skipped ? "skipped" : "ok";
+    int32_t repeats = timing -> skipped ? 0 : timing -> repeats;
+    double min_ms = timing -> skipped ? 0 : timing -> min_ms;
+    double median_ms = timing -> skipped ? 0 : timing -> median_ms;
+    double mean_ms = timing -> skipped ? 0 : timing -> mean_ms;
+    if (args -> format == FORMAT_JSON)
+    {
+        printf("%s  {\"stage\": \"%s\", \"generator\": \"%s\", "
+               "\"solver\": \"%s\", \"rows\": %"PRIi32", "
+               "\"columns\": %"PRIi32", \"seed\": %"PRIu64", "
+               "\"threads\": %"PRIi32", "
+               "\"repeats\": %"PRIi32", \"min_ms\": %.6f, "
+               "\"median_ms\": %.6f, \"mean_ms\": %.6f, "
+               "\"cells_per_second\": %.0f, \"peak_rss_kib\": %ld, "
+               "\"status\": \"%s\"}",
+               first ? "" : ",\n",
+               stage_names[stage], generator_name(bench -> generator),
+               solver_name(bench -> solver), odd, odd, bench -> seed,
+               bench -> threads, repeats,
+               min_ms, median_ms, mean_ms, cells_per_second, peak_kib,
+               status);
+        return;
+    }
+
+    printf("%s,%s,%s,%"PRIi32",%"PRIi32",%"PRIu64",%"PRIi32",%"PRIi32","
+           "%.6f,%.6f,%.6f,%.0f,%ld,%s\n",
+           stage_names[stage], generator_name(bench -> generator),
+           solver_name(bench -> solver), odd, odd, bench -> seed,
+           bench -> threads, repeats,
+           min_ms, median_ms, mean_ms, cells_per_second, peak_kib, status);
+}
+
+static void print_kernel_row(
+        const Arguments *args, enum BENCH_KERNELS kernel,
+        const char *implementation, int32_t size,
+        const BenchTiming *timing, bool first)
+{
+    int32_t odd = size - (size % 2 == 0);
+    double cells = (double)odd * odd;
+    double cells_per_second = timing -> skipped || timing -> median_ms <= 0 ?
+        0 : cells / (timing -> median_ms / 1000);
+
+    const char *status = timing -> skipped ? "skipped" : "ok";
+    int32_t repeats = timing -> skipped ? 0 : timing -> repeats;
+    double min_ms = timing -> skipped ? 0 : timing -> min_ms;
+    double median_ms = timing -> skipped ? 0 : timing -> median_ms;
+    double mean_ms = timing -> skipped ? 0 : timing -> mean_ms;
+    if (args -> format == FORMAT_JSON)
+    {
+        printf("%s  {\"kernel\": \"%s\", \"implementation\": \"%s\", "
+               "\"rows\": %"PRIi32", \"columns\": %"PRIi32", "
+               "\"repeats\": %"PRIi32", \"min_ms\": %.6f, "
+               "\"median_ms\": %.6f, \"mean_ms\": %.6f, "
+               "\"cells_per_second\": %.0f, \"status\": \"%s\"}",
+               first ? "" : ",\n",
+               kernel_names[kernel], implementation, odd, odd, repeats,
+               min_ms, median_ms, mean_ms, cells_per_second, status);
+        return;
+    }
+
+    printf("%s,%s,%"PRIi32",%"PRIi32",%"PRIi32",%.6f,%.6f,%.6f,%.0f,%s\n",
+           kernel_names[kernel], implementation, odd, odd, repeats,
+           min_ms, median_ms, mean_ms, cells_per_second, status);
+}
+
+static void print_footer(const Arguments *args)
+{
+    if (args -> format == FORMAT_JSON)
+    {
+        printf("\n]\n");
+    }
+}
+
+static error_t parse_opt(int32_t key, char *arg, struct argp_state *state)
+{
+    Arguments *args = state -> input;
+    char *endptr = NULL;
+    errno = 0;
+    switch (key)
+    {
+        case 'h':
+            argp_state_help(state, state -> out_stream, ARGP_HELP_STD_HELP);
+            break;
+
+        case 'v':
+            fprintf(state -> out_stream, "%s", argp_program_version);
+            exit(EXIT_SUCCESS);
+            break;
+
+        case OPTION_SIZES:
+        case OPTION_SEEDS:
+        case OPTION_GENERATORS:
+        case OPTION_SOLVERS:
+        case OPTION_THREADS:
+            if (!set_list(args, key, arg))
+            {
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case OPTION_REPEATS:
+            args -> repeats = strtol(arg, &endptr, 10);
+            if (errno != 0 || endptr == arg || *endptr != '\0' ||
+                    args -> repeats <= 0 ||
+                    args -> repeats > BENCH_MAX_REPEATS)
+            {
+                fprintf(stderr, "Repeats must be between [1, %d]\n",
+                        BENCH_MAX_REPEATS);
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case OPTION_MIN_TIME:
+            args -> min_time = strtod(arg, &endptr);
+            if (errno != 0 || endptr == arg || *endptr != '\0' ||
+                    args -> min_time < 0)
+            {
+                fprintf(stderr, "Minimum time must be >= 0\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case OPTION_KERNELS:
+            args -> kernels = true;
+            break;
+
+        case OPTION_FORMAT:
+            if (strcmp(arg, "csv") == 0)
+            {
+                args -> format = FORMAT_CSV;
+            }
+
+            else if (strcmp(arg, "json") == 0)
+            {
+                args -> format = FORMAT_JSON;
+            }
+
+            else
+            {
+                fprintf(stderr, "Format must be csv or json\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        default:
+            return ARGP_ERR_UNKNOWN;
+    }
+
+    return 0;
+}
+
+// Replaces the list of key with the comma separated values of arg.
+static bool set_list(Arguments *args, int32_t key, char *arg)
+{
+    size_t count = 0;
+    for (char *value = strtok(arg, ","); value != NULL;
+            value = strtok(NULL, ","))
+    {
+        if (count == BENCH_MAX_LIST)
+        {
+            fprintf(stderr, "Lists can't have more than %d values\n",
+                    BENCH_MAX_LIST);
+            return false;
+        }
+
+        if (key == OPTION_GENERATORS)
+        {
+            enum GENERATORS generator = GENERATOR_BACKTRACKER;
+            if (!parse_generator(value, &generator))
+            {
+                fprintf(stderr, "Generator must be backtracker, kruskal, "
+                        "wilson or eller\n");
+                return false;
+            }
+
+            args -> generators[count++] = generator;
+            continue;
+        }
+
+        if (key == OPTION_SOLVERS)
+        {
+            enum SOLVERS solver = SOLVER_FORKING;
+            if (!parse_solver(value, &solver))
+            {
+                fprintf(stderr, "Solver must be forking, bidirectional, "
+                        "astar, jps, junctions, compact or bitboard\n");
+                return false;
+            }
+
+            args -> solvers[count++] = solver;
+            continue;
+        }
+
+        char *endptr = NULL;
+        errno = 0;
+        uint64_t number = strtoull(value, &endptr, 10);
+        if (errno != 0 || endptr == value || *endptr != '\0')
+        {
+            fprintf(stderr, "Invalid number on list: %s\n", value);
+            return false;
+        }
+
+        if (key == OPTION_SEEDS)
+        {
+            args -> seeds[count++] = number;
+        }
+
+        else if (number == 0 || number > (key == OPTION_SIZES ?
+                    (uint64_t)INT32_MAX : (uint64_t)INT16_MAX))
+        {
+            fprintf(stderr, "%s must be between [1, %"PRIi32"]\n",
+                    key == OPTION_SIZES ? "Sizes" : "Threads",
+                    key == OPTION_SIZES ? INT32_MAX : INT16_MAX);
+            return false;
+        }
+
+        else if (key == OPTION_SIZES)
+        {
+            args -> sizes[count++] = number;
+        }
+
+        else
+        {
+            args -> threads[count++] = number;
+        }
+    }
+
+    if (count == 0)
+    {
+        fprintf(stderr, "Lists can't be empty\n");
+        return false;
+    }
+
+    switch (key)
+    {
+        case OPTION_SIZES: args -> sizes_count = count; break;
+        case OPTION_SEEDS: args -> seeds_count = count; break;
+        case OPTION_GENERATORS: args -> generators_count = count; break;
+        case OPTION_SOLVERS: args -> solvers_count = count; break;
+        default: args -> threads_count = count; break;
+    }
+
+    return true;
+}
+
+static bool parse_generator(const char *name, enum GENERATORS *generator)
+{
+    for (enum GENERATORS g = GENERATOR_BACKTRACKER; g <= GENERATOR_ELLER; g++)
+    {
+        if (strcmp(name, generator_name(g)) == 0)
+        {
+            *generator = g;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool parse_solver(const char *name, enum SOLVERS *solver)
+{
+    for (enum SOLVERS v = SOLVER_FORKING; v < SOLVERS_COUNT; v++)
+    {
+        if (strcmp(name, solver_name(v)) == 0)
+        {
+            *solver = v;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,228 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // exit.
+#include "bidirectional.h"
+
+static bool side_step(
+        Frontier *own, const Frontier *other, bool from_end,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node);
+
+static enum MOVE_STATES move_side(
+        Tree *node, bool from_end,
+        Arena *arena, Maze *maze, Frontier *frontier, DirtyCells *dirty,
+        size_t *contact);
+
+static inline bool owned_by_end(uint8_t type);
+static inline bool owned_by_start(uint8_t type);
+static Tree * find_head(const Frontier *frontier, const Maze *maze,
+        size_t cell);
+static Tree * join_halves(
+        Tree *forward, Tree *backward, Maze *maze, DirtyCells *dirty);
+
+// The root from END goes on backward, the one from START is the caller's.
+bool bidirectional_init(Frontier *backward, Arena *arena, Maze *maze)
+{
+    Tree *root = create_node(arena);
+    if (root == NULL)
+    {
+        return false;
+    }
+
+    root -> head_x = maze -> end_x;
+    root -> head_y = maze -> end_y;
+    return frontier_init(backward, root);
+}
+
+// Returns true if atleast one node of either tree moved.
+bool bidirectional_step(
+        Frontier *forward, Frontier *backward,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node)
+{
+    bool moved = side_step(forward, backward, false,
+            arena, maze, dirty, end_reached, winner_node);
+
+    if (*end_reached)
+    {
+        return moved;
+    }
+
+    return side_step(backward, forward, true,
+            arena, maze, dirty, end_reached, winner_node) || moved;
+}
+
+// Same as forking_step() for the heads of one tree, the first contact with the
+// other tree joins them.
+static bool side_step(
+        Frontier *own, const Frontier *other, bool from_end,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node)
+{
+    bool atleast_one_node_moved = false;
+    for (size_t head = 0; head < own -> heads_count; head++)
+    {
+        Tree *node_to_mv = own -> heads[head];
+        size_t contact = 0;
+        enum MOVE_STATES result = move_side(
+                node_to_mv, from_end, arena, maze, own, dirty, &contact);
+
+        // Do not break yet, we want each node to move or be dead on each
+        // turn, as forking_step() does.
+        if (result == NODE_END_REACHED && !*end_reached)
+        {
+            Tree *touched = find_head(other, maze, contact);
+            *end_reached = true;
+            *winner_node = from_end ?
+                join_halves(touched, node_to_mv, maze, dirty) :
+                join_halves(node_to_mv, touched, maze, dirty);
+        }
+
+        if (result != NODE_CANT_MOVE)
+        {
+            atleast_one_node_moved = true;
+        }
+    }
+
+    frontier_swap(own);
+    return atleast_one_node_moved;
+}
+
+// move_node() with the tags of the tree from_end (or from START), a move into
+// a cell of the other tree is not made but reported on contact.
+static enum MOVE_STATES move_side(
+        Tree *node, bool from_end,
+        Arena *arena, Maze *maze, Frontier *frontier, DirtyCells *dirty,
+        size_t *contact)
+{
+    enum MAZE_MOVES moves[] = {LEFT, UP, DOWN, RIGHT};
+    size_t move_quantity = sizeof(moves) / sizeof(enum MAZE_MOVES);
+    uint8_t body = from_end ? END_BODY : BODY;
+    uint8_t dead_head = from_end ? END_DEAD_HEAD : DEAD_HEAD;
+    uint8_t live_head = from_end ? END_LIVE_HEAD : LIVE_HEAD;
+
+    size_t head = maze_index(maze, node -> head_x, node -> head_y);
+    bool touched = false;
+    maze -> types[head] = dead_head;
+    if (dirty != NULL)
+    {
+        dirty_push(dirty, head);
+    }
+
+    for (size_t move = 0; move < move_quantity; move++)
+    {
+        if ((moves[move] == LEFT && node -> head_x <= 0) ||
+            (moves[move] == RIGHT &&
+                node -> head_x >= maze -> columns - 1) ||
+            (moves[move] == UP && node -> head_y <= 0) ||
+            (moves[move] == DOWN && node -> head_y >= maze -> rows - 1))
+        {
+            continue;
+        }
+
+        int32_t tx = node -> head_x + (moves[move] == LEFT ? -1 :
+                                        moves[move] == RIGHT ? 1 : 0);
+        int32_t ty = node -> head_y + (moves[move] == UP ? -1 :
+                                        moves[move] == DOWN ? 1 : 0);
+        size_t target = maze_index(maze, tx, ty);
+
+        uint8_t type = maze -> types[target];
+        if (type != EMPTY && (from_end ? owned_by_start(type) :
+                    owned_by_end(type)))
+        {
+            if (!touched)
+            {
+                *contact = target;
+                touched = true;
+            }
+            continue;
+        }
+
+        if (type != EMPTY)
+        {
+            continue;
+        }
+
+        Tree *child = create_node(arena);
+        if (child == NULL)
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        node -> children[node -> children_count] = child;
+        child -> parent_move = moves[move];
+        child -> head_x = tx;
+        child -> head_y = ty;
+        child -> parent = node;
+        child -> parent_index = node -> children_count;
+        child -> distance_runned = node -> distance_runned + 1;
+        node -> children_count += 1;
+        frontier_push(frontier, child);
+
+        maze -> types[head] = body;
+        maze -> types[target] = live_head;
+        maze_set_distance(maze, target, node -> distance_runned + 1);
+        if (dirty != NULL)
+        {
+            dirty_push(dirty, target);
+        }
+    }
+
+    return touched ? NODE_END_REACHED : node -> children_count > 0 ?
+                NODE_MOVED : NODE_CANT_MOVE;
+}
+
+static inline bool owned_by_end(uint8_t type)
+{
+    return type == END || type == END_BODY || type == END_DEAD_HEAD ||
+        type == END_LIVE_HEAD;
+}
+
+static inline bool owned_by_start(uint8_t type)
+{
+    return type == START || type == BODY || type == DEAD_HEAD ||
+        type == LIVE_HEAD;
+}
+
+// Only reached on contact, a single scan of the other frontier.
+static Tree * find_head(const Frontier *frontier, const Maze *maze,
+        size_t cell)
+{
+    for (size_t head = 0; head < frontier -> heads_count; head++)
+    {
+        Tree *node = frontier -> heads[head];
+        if (maze_index(maze, node -> head_x, node -> head_y) == cell)
+        {
+            return node;
+        }
+    }
+
+    return NULL;
+}
+
+// Reverses the parents from backward up to the root at END and hangs them
+// from forward, returns where the walk to START begins. As with the forking
+// solver END itself isn't part of the walk, it starts next to it.
+// The reversed nodes are renumbered as run from START, so END gets the length
+// of the path as it does with the forking solver.
+static Tree * join_halves(
+        Tree *forward, Tree *backward, Maze *maze, DirtyCells *dirty)
+{
+    Tree *previous = forward;
+    while (backward != NULL)
+    {
+        Tree *next = backward -> parent;
+        backward -> parent = previous;
+        backward -> distance_runned = previous -> distance_runned + 1;
+        size_t cell = maze_index(maze, backward -> head_x, backward -> head_y);
+        maze_set_distance(maze, cell, backward -> distance_runned);
+        if (dirty != NULL)
+        {
+            dirty_push(dirty, cell);
+        }
+
+        previous = backward;
+        backward = next;
+    }
+
+    return previous -> parent;
+}
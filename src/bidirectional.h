@@ -0,0 +1,24 @@
+#ifndef BIDIRECTIONAL_H
+#define BIDIRECTIONAL_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include "arena.h"      // Arena, bump allocator for the nodes of the tree.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // Tree, Frontier and DirtyCells.
+
+// A second tree grows from END at the same pace as the one from START, every
+// generation moves the heads from START and then the heads from END.
+// Cells of the tree from END are tagged END_BODY, END_DEAD_HEAD and
+// END_LIVE_HEAD, a head that tries to move into a cell of the other tree has
+// found the path: that cell is always a live head of the other frontier.
+// Both halves are joined into a single chain from END to START, so the winner
+// path is walked through parent as with the forking solver, and its cells from
+// END get the distances from START so the reported Distance is the one of the
+// whole path.
+bool bidirectional_init(Frontier *backward, Arena *arena, Maze *maze);
+bool bidirectional_step(
+        Frontier *forward, Frontier *backward,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node);
+
+#endif // BIDIRECTIONAL_H
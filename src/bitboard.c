@@ -0,0 +1,248 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc, calloc, realloc, free and exit.
+#include "bitboard.h"
+#include "grid-kernels.h"   // Open cells packed into words.
+
+static uint64_t spread(BitboardSolver *solver, size_t word, uint64_t cells);
+static void paint_word(
+        Maze *maze, DirtyCells *dirty,
+        const BitboardSolver *solver, size_t word,
+        uint64_t cells, uint64_t parents, uint8_t type, int64_t distance);
+
+bool bitboard_init(BitboardSolver *solver, const Maze *maze)
+{
+    *solver = (BitboardSolver){0};
+    solver -> row_words = ((size_t)maze -> columns + 63) / 64;
+    solver -> words_count = solver -> row_words * maze -> rows;
+    solver -> frontier_capacity = 64;
+    solver -> next_capacity = 64;
+    solver -> words = calloc(solver -> words_count, sizeof(BitboardWord));
+    solver -> frontier_words =
+        malloc(sizeof(size_t) * solver -> frontier_capacity);
+    solver -> next_words = malloc(sizeof(size_t) * solver -> next_capacity);
+    uint64_t *row = malloc(sizeof(uint64_t) * solver -> row_words);
+
+    if (solver -> words == NULL || solver -> frontier_words == NULL ||
+            solver -> next_words == NULL || row == NULL)
+    {
+        perror("Failed to allocate memory for bitboard solver\n");
+        free(row);
+        bitboard_free(solver);
+        return false;
+    }
+
+    for (int32_t y = 0; y < maze -> rows; y++)
+    {
+        BitboardWord *words = solver -> words + y * solver -> row_words;
+        grid_bits(maze -> types + maze_index(maze, 0, y), maze -> columns,
+                1 << EMPTY | 1 << END, row);
+
+        for (size_t word = 0; word < solver -> row_words; word++)
+        {
+            words[word].open = row[word];
+        }
+    }
+
+    free(row);
+    size_t start = (size_t)maze -> start_y * solver -> row_words +
+        maze -> start_x / 64;
+
+    solver -> words[start].heads[0] = (uint64_t)1 << maze -> start_x % 64;
+    solver -> frontier_words[0] = start;
+    solver -> frontier_count = 1;
+    solver -> heads_count = 1;
+    return true;
+}
+
+// Returns true if atleast one head moved. Heads that made a child are left as
+// BODY and the rest as DEAD_HEAD, like forking_step() does.
+bool bitboard_step(
+        BitboardSolver *solver, Maze *maze, DirtyCells *dirty,
+        bool *end_reached)
+{
+    BitboardWord *words = solver -> words;
+    size_t row_words = solver -> row_words;
+    int32_t current = solver -> current;
+    int64_t level = solver -> level + 1;
+
+    // Each claimed cell is shifted back onto the head that claimed it, so
+    // the heads are painted as soon as they're expanded.
+    for (size_t i = 0; i < solver -> frontier_count; i++)
+    {
+        size_t word = solver -> frontier_words[i];
+        size_t column = word % row_words;
+        uint64_t heads = words[word].heads[current];
+        uint64_t parents = spread(solver, word, heads << 1) >> 1 |
+            spread(solver, word, heads >> 1) << 1;
+
+        if (column > 0)
+        {
+            parents |= spread(solver, word - 1, heads << 63) >> 63;
+        }
+
+        if (column < row_words - 1)
+        {
+            parents |= spread(solver, word + 1, heads >> 63) << 63;
+        }
+
+        if (word >= row_words)
+        {
+            parents |= spread(solver, word - row_words, heads);
+        }
+
+        if (word + row_words < solver -> words_count)
+        {
+            parents |= spread(solver, word + row_words, heads);
+        }
+
+        paint_word(maze, dirty, solver, word, heads, parents, DEAD_HEAD,
+                level - 1);
+
+        words[word].heads[current] = 0;
+    }
+
+    solver -> heads_count = 0;
+    for (size_t i = 0; i < solver -> next_count; i++)
+    {
+        size_t word = solver -> next_words[i];
+        uint64_t claimed = words[word].heads[!current];
+        words[word].open &= ~claimed;
+        words[word].levels[0] |= level & 1 ? claimed : 0;
+        words[word].levels[1] |= level & 2 ? claimed : 0;
+        paint_word(maze, dirty, solver, word, claimed, 0, LIVE_HEAD, level);
+        solver -> heads_count += __builtin_popcountll(claimed);
+    }
+
+    const BitboardWord *end = bitboard_word(solver,
+            maze -> end_x, maze -> end_y);
+
+    if (!*end_reached && end -> heads[!current] >> maze -> end_x % 64 & 1)
+    {
+        *end_reached = true;
+        enum MAZE_MOVES move = bitboard_parent(solver, maze,
+                maze -> end_x, maze -> end_y);
+
+        solver -> winner = maze_index(maze,
+                maze -> end_x + (move == LEFT ? -1 : move == RIGHT ? 1 : 0),
+                maze -> end_y + (move == UP ? -1 : move == DOWN ? 1 : 0));
+    }
+
+    size_t *frontier_words = solver -> frontier_words;
+    size_t frontier_capacity = solver -> frontier_capacity;
+    solver -> frontier_words = solver -> next_words;
+    solver -> frontier_count = solver -> next_count;
+    solver -> frontier_capacity = solver -> next_capacity;
+    solver -> next_words = frontier_words;
+    solver -> next_count = 0;
+    solver -> next_capacity = frontier_capacity;
+    solver -> current = !current;
+    solver -> level = level;
+    return solver -> frontier_count > 0;
+}
+
+// Move from a claimed cell towards the claimed neighbour a level below it,
+// NONE for START.
+enum MAZE_MOVES bitboard_parent(
+        const BitboardSolver *solver, const Maze *maze,
+        int32_t x, int32_t y)
+{
+    enum MAZE_MOVES moves[] = {LEFT, UP, DOWN, RIGHT};
+    size_t move_quantity = sizeof(moves) / sizeof(enum MAZE_MOVES);
+    int32_t parent_level = (bitboard_level(solver, x, y) + 3) % 4;
+    for (size_t move = 0; move < move_quantity; move++)
+    {
+        int32_t nx = x + (moves[move] == LEFT ? -1 :
+                moves[move] == RIGHT ? 1 : 0);
+        int32_t ny = y + (moves[move] == UP ? -1 :
+                moves[move] == DOWN ? 1 : 0);
+
+        if (nx < 0 || nx >= maze -> columns || ny < 0 || ny >= maze -> rows ||
+                maze -> types[maze_index(maze, nx, ny)] == WALL ||
+                bitboard_word(solver, nx, ny) -> open >> nx % 64 & 1)
+        {
+            continue;
+        }
+
+        if (bitboard_level(solver, nx, ny) == parent_level)
+        {
+            return moves[move];
+        }
+    }
+
+    return NONE;
+}
+
+size_t bitboard_bytes(const BitboardSolver *solver)
+{
+    if (solver -> words == NULL)
+    {
+        return 0;
+    }
+
+    return sizeof(BitboardWord) * solver -> words_count + sizeof(size_t) *
+        (solver -> frontier_capacity + solver -> next_capacity);
+}
+
+void bitboard_free(BitboardSolver *solver)
+{
+    free(solver -> words);
+    free(solver -> frontier_words);
+    free(solver -> next_words);
+    *solver = (BitboardSolver){0};
+}
+
+// Claims the open cells of word that are on cells and returns them, the word
+// is listed the first time it gets one.
+static uint64_t spread(BitboardSolver *solver, size_t word, uint64_t cells)
+{
+    BitboardWord *next = &solver -> words[word];
+    cells &= next -> open;
+    if (cells == 0)
+    {
+        return 0;
+    }
+
+    if (next -> heads[!solver -> current] == 0)
+    {
+        if (solver -> next_count == solver -> next_capacity)
+        {
+            solver -> next_capacity *= 2;
+            solver -> next_words = realloc(solver -> next_words,
+                    sizeof(size_t) * solver -> next_capacity);
+
+            if (solver -> next_words == NULL)
+            {
+                perror("Failed to allocate memory for bitboard solver\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        solver -> next_words[solver -> next_count++] = word;
+    }
+
+    next -> heads[!solver -> current] |= cells;
+    return cells;
+}
+
+// Cells of word become BODY if they're on parents and type otherwise.
+static void paint_word(
+        Maze *maze, DirtyCells *dirty,
+        const BitboardSolver *solver, size_t word,
+        uint64_t cells, uint64_t parents, uint8_t type, int64_t distance)
+{
+    size_t row = word / solver -> row_words;
+    size_t first = row * maze -> columns +
+        (word - row * solver -> row_words) * 64;
+
+    for (; cells != 0; cells &= cells - 1)
+    {
+        int32_t bit = __builtin_ctzll(cells);
+        size_t cell = first + bit;
+        maze -> types[cell] = parents >> bit & 1 ? BODY : type;
+        maze_set_distance(maze, cell, distance);
+        if (dirty != NULL)
+        {
+            dirty_push(dirty, cell);
+        }
+    }
+}
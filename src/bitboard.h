@@ -0,0 +1,72 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // DirtyCells and enum MAZE_MOVES.
+
+// Same generations as forking_step() on bitsets instead of heads: every row
+// is words of 64 cells and a generation is
+//      next = (left | right | up | down of frontier) & open
+// done a word at a time. Only the words with a head are expanded, their
+// indices are kept on a list, so a generation costs the frontier and not the
+// whole grid.
+// The level of every claimed cell is kept modulo 4 on 2 bitsets, neighbours
+// on a grid are a level apart so the parent of a cell is the claimed
+// neighbour a level below. That's enough to walk the winner path back.
+// The bitsets are interleaved, a generation reads and writes all of them for
+// the same cells so they share cache lines.
+typedef struct BitboardWord
+{
+    uint64_t open;              // EMPTY and END cells not claimed yet.
+    uint64_t heads[2];          // Frontier and next, swapped every step.
+    uint64_t levels[2];         // Bits 0 and 1 of the level of each cell.
+} BitboardWord;
+
+typedef struct BitboardSolver
+{
+    size_t row_words;           // Words per row.
+    size_t words_count;
+    BitboardWord *words;
+    int32_t current;            // Heads of the frontier, the other is next.
+    size_t *frontier_words;     // Indices of the words with a head.
+    size_t frontier_count;
+    size_t frontier_capacity;
+    size_t *next_words;
+    size_t next_count;
+    size_t next_capacity;
+    size_t heads_count;
+    int64_t level;              // Of the frontier.
+    size_t winner;              // Cell of the head that reached END.
+} BitboardSolver;
+
+bool bitboard_init(BitboardSolver *solver, const Maze *maze);
+bool bitboard_step(
+        BitboardSolver *solver, Maze *maze, DirtyCells *dirty,
+        bool *end_reached);
+
+enum MAZE_MOVES bitboard_parent(
+        const BitboardSolver *solver, const Maze *maze,
+        int32_t x, int32_t y);
+
+size_t bitboard_bytes(const BitboardSolver *solver);
+void bitboard_free(BitboardSolver *solver);
+
+static inline const BitboardWord * bitboard_word(
+        const BitboardSolver *solver, int32_t x, int32_t y)
+{
+    return &solver -> words[(size_t)y * solver -> row_words + x / 64];
+}
+
+// Level modulo 4 of a claimed cell.
+static inline int32_t bitboard_level(
+        const BitboardSolver *solver, int32_t x, int32_t y)
+{
+    const BitboardWord *word = bitboard_word(solver, x, y);
+    return (word -> levels[0] >> (x % 64) & 1) |
+        (word -> levels[1] >> (x % 64) & 1) << 1;
+}
+
+#endif // BITBOARD_H
@@ -0,0 +1,130 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc, calloc, realloc, free and exit.
+#include "compact.h"
+
+static void push_head(CompactSolver *solver, size_t cell);
+
+bool compact_init(CompactSolver *solver, const Maze *maze)
+{
+    *solver = (CompactSolver){0};
+    solver -> heads_capacity = 64;
+    solver -> next_heads_capacity = 64;
+    solver -> parents = calloc((maze_cells(maze) + 3) / 4, sizeof(uint8_t));
+    solver -> heads = malloc(sizeof(size_t) * solver -> heads_capacity);
+    solver -> next_heads =
+        malloc(sizeof(size_t) * solver -> next_heads_capacity);
+
+    if (solver -> parents == NULL || solver -> heads == NULL ||
+            solver -> next_heads == NULL)
+    {
+        perror("Failed to allocate memory for compact solver\n");
+        compact_free(solver);
+        return false;
+    }
+
+    solver -> heads[0] = maze_index(maze, maze -> start_x, maze -> start_y);
+    solver -> heads_count = 1;
+    return true;
+}
+
+// Returns true if atleast one head moved, heads move as in move_node().
+bool compact_step(
+        CompactSolver *solver, Maze *maze, DirtyCells *dirty,
+        bool *end_reached)
+{
+    enum MAZE_MOVES moves[] = {LEFT, UP, DOWN, RIGHT};
+    size_t move_quantity = sizeof(moves) / sizeof(enum MAZE_MOVES);
+    size_t end = maze_index(maze, maze -> end_x, maze -> end_y);
+    size_t columns = maze -> columns;
+    bool atleast_one_node_moved = false;
+
+    for (size_t i = 0; i < solver -> heads_count; i++)
+    {
+        size_t head = solver -> heads[i];
+        int32_t x = maze_index_x(maze, head);
+        int32_t y = maze_index_y(maze, head);
+        int64_t distance = maze -> distances_runned[head];
+
+        paint_cell(maze, dirty, head, DEAD_HEAD, distance);
+        for (size_t move = 0; move < move_quantity; move++)
+        {
+            if ((moves[move] == LEFT && x <= 0) ||
+                (moves[move] == RIGHT && x >= maze -> columns - 1) ||
+                (moves[move] == UP && y <= 0) ||
+                (moves[move] == DOWN && y >= maze -> rows - 1))
+            {
+                continue;
+            }
+
+            size_t target = moves[move] == LEFT ? head - 1 :
+                moves[move] == RIGHT ? head + 1 :
+                moves[move] == UP ? head - columns : head + columns;
+
+            if (maze -> types[target] != EMPTY && target != end)
+            {
+                continue;
+            }
+
+            compact_set_parent(solver -> parents, target,
+                    moves[move] == LEFT ? RIGHT : moves[move] == RIGHT ?
+                    LEFT : moves[move] == UP ? DOWN : UP);
+
+            push_head(solver, target);
+            paint_cell(maze, dirty, head, BODY, distance);
+            paint_cell(maze, dirty, target, LIVE_HEAD, distance + 1);
+            atleast_one_node_moved = true;
+            if (target == end && !*end_reached)
+            {
+                *end_reached = true;
+                solver -> winner = head;
+            }
+        }
+    }
+
+    size_t *heads = solver -> heads;
+    size_t heads_capacity = solver -> heads_capacity;
+    solver -> heads = solver -> next_heads;
+    solver -> heads_count = solver -> next_heads_count;
+    solver -> heads_capacity = solver -> next_heads_capacity;
+    solver -> next_heads = heads;
+    solver -> next_heads_count = 0;
+    solver -> next_heads_capacity = heads_capacity;
+    return atleast_one_node_moved;
+}
+
+size_t compact_bytes(const CompactSolver *solver, const Maze *maze)
+{
+    if (solver -> parents == NULL)
+    {
+        return 0;
+    }
+
+    return (maze_cells(maze) + 3) / 4 + sizeof(size_t) *
+        (solver -> heads_capacity + solver -> next_heads_capacity);
+}
+
+void compact_free(CompactSolver *solver)
+{
+    free(solver -> parents);
+    free(solver -> heads);
+    free(solver -> next_heads);
+    *solver = (CompactSolver){0};
+}
+
+static void push_head(CompactSolver *solver, size_t cell)
+{
+    if (solver -> next_heads_count == solver -> next_heads_capacity)
+    {
+        solver -> next_heads_capacity *= 2;
+        solver -> next_heads = realloc(solver -> next_heads,
+                sizeof(size_t) * solver -> next_heads_capacity);
+
+        if (solver -> next_heads == NULL)
+        {
+            perror("Failed to allocate memory for compact solver\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    solver -> next_heads[solver -> next_heads_count++] = cell;
+}
@@ -0,0 +1,51 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // DirtyCells and enum MAZE_MOVES.
+
+// Same search as forking_step() without a tree: every claimed cell keeps the
+// move towards the cell that claimed it in 2 bits and the frontier is a list
+// of cells. The winner path is walked back from END through those moves.
+// Besides the grid that's a quarter of a byte per cell plus the live heads,
+// instead of a 64 bytes node per visited cell.
+typedef struct CompactSolver
+{
+    uint8_t *parents;           // 2 bits per cell, 4 cells per byte.
+    size_t *heads;
+    size_t heads_count;
+    size_t heads_capacity;
+    size_t *next_heads;
+    size_t next_heads_count;
+    size_t next_heads_capacity;
+    size_t winner;              // Cell of the head that reached END.
+} CompactSolver;
+
+bool compact_init(CompactSolver *solver, const Maze *maze);
+bool compact_step(
+        CompactSolver *solver, Maze *maze, DirtyCells *dirty,
+        bool *end_reached);
+
+size_t compact_bytes(const CompactSolver *solver, const Maze *maze);
+void compact_free(CompactSolver *solver);
+
+// Move from cell towards its parent, only meaningful for claimed cells.
+static inline enum MAZE_MOVES compact_parent(
+        const uint8_t *parents, size_t cell)
+{
+    uint8_t bits = parents[cell / 4] >> (cell % 4 * 2) & 3;
+    return bits == 0 ? LEFT : bits == 1 ? UP : bits == 2 ? DOWN : RIGHT;
+}
+
+// Cells are claimed once so their bits start at 0.
+static inline void compact_set_parent(
+        uint8_t *parents, size_t cell, enum MAZE_MOVES move)
+{
+    uint8_t bits = move == LEFT ? 0 : move == UP ? 1 : move == DOWN ? 2 : 3;
+    parents[cell / 4] |= bits << (cell % 4 * 2);
+}
+
+#endif // COMPACT_H
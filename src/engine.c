@@ -0,0 +1,279 @@
+// pthread_barrier_t (from parallel-solver.h) isn't part of c99.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>      // perror.
+#include <string.h>     // memcpy.
+#include "engine.h"
+#include "platform.h"   // get_time_ms().
+
+static void * engine_loop(void *data);
+static bool engine_step(Engine *engine);
+static void engine_publish(Engine *engine, bool wait);
+
+// The snapshot starts as a copy of maze, the renderer paints it whole first.
+bool engine_start(
+        Engine *engine, enum SOLVERS solver,
+        Tree *root, Arena *arena, Maze *maze,
+        int32_t threads)
+{
+    engine -> maze = maze;
+    engine -> walk = (PathWalk){0};
+    engine -> budget = 0;
+    engine -> paused = false;
+    engine -> quit = false;
+    engine -> done = false;
+    engine -> end_reached = false;
+    engine -> stats = (EngineStats){0};
+    engine -> snapshot_stats = (EngineStats){0};
+
+    engine -> snapshot = maze_clone(maze);
+    if (engine -> snapshot == NULL)
+    {
+        return false;
+    }
+
+    if (!solver_init(&engine -> solver, solver, root, arena, maze, threads))
+    {
+        maze_free(engine -> snapshot);
+        return false;
+    }
+
+    if (!dirty_init(&engine -> dirty, DIRTY_CELLS_CAPACITY) ||
+            !dirty_init(&engine -> snapshot_dirty, DIRTY_CELLS_CAPACITY))
+    {
+        dirty_free(&engine -> dirty);
+        solver_free(&engine -> solver);
+        maze_free(engine -> snapshot);
+        return false;
+    }
+
+    // Nothing changed yet since the copy.
+    dirty_clear(&engine -> dirty);
+
+    pthread_mutex_init(&engine -> snapshot_lock, NULL);
+    pthread_mutex_init(&engine -> wake_lock, NULL);
+    pthread_cond_init(&engine -> wake, NULL);
+    if (pthread_create(&engine -> thread, NULL, engine_loop, engine) != 0)
+    {
+        perror("Failed to create engine thread\n");
+        pthread_cond_destroy(&engine -> wake);
+        pthread_mutex_destroy(&engine -> wake_lock);
+        pthread_mutex_destroy(&engine -> snapshot_lock);
+        dirty_free(&engine -> dirty);
+        dirty_free(&engine -> snapshot_dirty);
+        solver_free(&engine -> solver);
+        maze_free(engine -> snapshot);
+        return false;
+    }
+
+    return true;
+}
+
+// Replaces the steps left, they don't pile up if the engine is behind.
+void engine_grant(Engine *engine, int64_t steps)
+{
+    pthread_mutex_lock(&engine -> wake_lock);
+    engine -> budget = steps;
+    pthread_cond_signal(&engine -> wake);
+    pthread_mutex_unlock(&engine -> wake_lock);
+}
+
+void engine_pause(Engine *engine, bool paused)
+{
+    pthread_mutex_lock(&engine -> wake_lock);
+    engine -> paused = paused;
+    pthread_cond_signal(&engine -> wake);
+    pthread_mutex_unlock(&engine -> wake_lock);
+}
+
+// True once there is nothing left to solve nor to mark of the winner path.
+bool engine_done(Engine *engine)
+{
+    pthread_mutex_lock(&engine -> wake_lock);
+    bool done = engine -> done;
+    pthread_mutex_unlock(&engine -> wake_lock);
+    return done;
+}
+
+void engine_lock_snapshot(Engine *engine)
+{
+    pthread_mutex_lock(&engine -> snapshot_lock);
+}
+
+void engine_unlock_snapshot(Engine *engine)
+{
+    pthread_mutex_unlock(&engine -> snapshot_lock);
+}
+
+// Moves the stats gathered since the last call into stats, the caller must
+// hold the snapshot.
+void engine_take_stats(Engine *engine, EngineStats *stats)
+{
+    *stats = engine -> snapshot_stats;
+    engine -> snapshot_stats.solve_ms = 0;
+    engine -> snapshot_stats.walk_ms = 0;
+    engine -> snapshot_stats.publish_ms = 0;
+    engine -> snapshot_stats.steps = 0;
+}
+
+// Stops the engine wherever it is and frees it, maze keeps the state it had.
+// Returns true if the end was reached.
+bool engine_stop(Engine *engine)
+{
+    pthread_mutex_lock(&engine -> wake_lock);
+    engine -> quit = true;
+    pthread_cond_signal(&engine -> wake);
+    pthread_mutex_unlock(&engine -> wake_lock);
+    pthread_join(engine -> thread, NULL);
+
+    bool end_reached = engine -> end_reached;
+    pthread_cond_destroy(&engine -> wake);
+    pthread_mutex_destroy(&engine -> wake_lock);
+    pthread_mutex_destroy(&engine -> snapshot_lock);
+    dirty_free(&engine -> dirty);
+    dirty_free(&engine -> snapshot_dirty);
+    solver_free(&engine -> solver);
+    maze_free(engine -> snapshot);
+    engine -> snapshot = NULL;
+    return end_reached;
+}
+
+static void * engine_loop(void *data)
+{
+    Engine *engine = data;
+    bool finished = false;
+    while (!finished)
+    {
+        pthread_mutex_lock(&engine -> wake_lock);
+        while (!engine -> quit && (engine -> paused || engine -> budget == 0))
+        {
+            pthread_cond_wait(&engine -> wake, &engine -> wake_lock);
+        }
+
+        if (engine -> quit)
+        {
+            pthread_mutex_unlock(&engine -> wake_lock);
+            return NULL;
+        }
+
+        if (engine -> budget > 0)
+        {
+            engine -> budget -= 1;
+        }
+
+        pthread_mutex_unlock(&engine -> wake_lock);
+
+        finished = engine_step(engine);
+
+        // The last changes must reach the renderer, there won't be more steps
+        // to retry the publish.
+        engine_publish(engine, finished);
+    }
+
+    pthread_mutex_lock(&engine -> wake_lock);
+    engine -> done = true;
+    pthread_mutex_unlock(&engine -> wake_lock);
+    return NULL;
+}
+
+// Same step as the old frame loop: a solver step until the end is reached and
+// then a cell of the winner path. Returns true when there is nothing left.
+static bool engine_step(Engine *engine)
+{
+    Maze *maze = engine -> maze;
+    Solver *solver = &engine -> solver;
+    bool end_reached;
+
+    pthread_mutex_lock(&engine -> wake_lock);
+    end_reached = engine -> end_reached;
+    pthread_mutex_unlock(&engine -> wake_lock);
+
+    double start = get_time_ms();
+    engine -> stats.steps += 1;
+    if (end_reached)
+    {
+        size_t winner_cell;
+        if (path_walk_next(&engine -> walk, maze, &winner_cell))
+        {
+            maze -> types[winner_cell] = WIN_BLOCK;
+            dirty_push(&engine -> dirty, winner_cell);
+        }
+
+        engine -> stats.walk_ms += get_time_ms() - start;
+        return engine -> walk.done;
+    }
+
+    bool done = solver_step(solver, &engine -> dirty);
+    engine -> stats.solve_ms += get_time_ms() - start;
+    solver_measure(solver, &engine -> stats.frontier,
+            &engine -> stats.nodes, &engine -> stats.bytes);
+
+    if (solver -> end_reached)
+    {
+        pthread_mutex_lock(&engine -> wake_lock);
+        engine -> end_reached = true;
+        pthread_mutex_unlock(&engine -> wake_lock);
+        solver_path(solver, &engine -> walk);
+        return engine -> walk.done;
+    }
+
+    return done;
+}
+
+// Copies the changed cells and the stats into the snapshot. Unless wait is set
+// it gives up if the renderer holds the snapshot, the cells stay dirty and the
+// stats keep adding up for the next try.
+static void engine_publish(Engine *engine, bool wait)
+{
+    DirtyCells *dirty = &engine -> dirty;
+    if (wait)
+    {
+        pthread_mutex_lock(&engine -> snapshot_lock);
+    }
+
+    else if (pthread_mutex_trylock(&engine -> snapshot_lock) != 0)
+    {
+        return;
+    }
+
+    double start = get_time_ms();
+    const Maze *maze = engine -> maze;
+    Maze *snapshot = engine -> snapshot;
+    if (dirty -> everything)
+    {
+        memcpy(snapshot -> types, maze -> types,
+                maze_cells(maze) * sizeof(uint8_t));
+        memcpy(snapshot -> distances_runned, maze -> distances_runned,
+                maze_cells(maze) * sizeof(uint32_t));
+        engine -> snapshot_dirty.everything = true;
+    }
+
+    else
+    {
+        for (size_t i = 0; i < dirty -> count; i++)
+        {
+            size_t cell = dirty -> cells[i];
+            snapshot -> types[cell] = maze -> types[cell];
+            snapshot -> distances_runned[cell] =
+                maze -> distances_runned[cell];
+            dirty_push(&engine -> snapshot_dirty, cell);
+        }
+    }
+
+    EngineStats *stats = &engine -> snapshot_stats;
+    stats -> solve_ms += engine -> stats.solve_ms;
+    stats -> walk_ms += engine -> stats.walk_ms;
+    stats -> publish_ms += engine -> stats.publish_ms +
+        get_time_ms() - start;
+    stats -> steps += engine -> stats.steps;
+    stats -> frontier = engine -> stats.frontier;
+    stats -> nodes = engine -> stats.nodes;
+    stats -> bytes = engine -> stats.bytes;
+    pthread_mutex_unlock(&engine -> snapshot_lock);
+
+    dirty_clear(dirty);
+    engine -> stats.solve_ms = 0;
+    engine -> stats.walk_ms = 0;
+    engine -> stats.publish_ms = 0;
+    engine -> stats.steps = 0;
+}
@@ -0,0 +1,77 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include <pthread.h>    // pthread_t, pthread_mutex_t and pthread_cond_t.
+#include "arena.h"      // Arena, bump allocator for the nodes of the tree.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // Tree and DirtyCells.
+#include "solvers.h"    // Solver, the strategy stepped by the engine.
+
+// Steps the engine can take without being granted more.
+#define ENGINE_UNLIMITED_STEPS -1
+
+// What the engine did since the renderer last took its stats, times and steps
+// add up while the rest is the state after the last step.
+// Every allocation of the arenas is a node of the tree.
+typedef struct EngineStats
+{
+    double solve_ms;                // Generations of the solver.
+    double walk_ms;                 // Marking the winner path.
+    double publish_ms;              // Copying cells into the snapshot.
+    int64_t steps;
+    size_t frontier;                // Live heads.
+    size_t nodes;
+    size_t bytes;                   // Tree and open nodes.
+} EngineStats;
+
+// Runs the solver on its own thread so rendering only samples its progress.
+// A step is a solver_step() or, once the end is reached, a cell of the winner
+// path.
+// The engine owns maze while it runs and publishes the cells it changed into
+// snapshot, the renderer reads snapshot (and snapshot_dirty, the cells changed
+// since it last drew) holding snapshot_lock.
+// Publishing uses a try lock, if the renderer is drawing the changes are kept
+// for the next step so the solver never waits for a frame.
+typedef struct Engine
+{
+    pthread_t thread;
+    pthread_mutex_t snapshot_lock;
+    pthread_mutex_t wake_lock;
+    pthread_cond_t wake;
+
+    // Engine thread only.
+    Solver solver;
+    PathWalk walk;                  // Of the winner path once found.
+    Maze *maze;
+    DirtyCells dirty;               // Changed since the last publish.
+    EngineStats stats;              // Since the last publish.
+
+    // Guarded by snapshot_lock.
+    Maze *snapshot;
+    DirtyCells snapshot_dirty;      // Changed since the renderer drew.
+    EngineStats snapshot_stats;     // Since the renderer took them.
+
+    // Guarded by wake_lock.
+    int64_t budget;                 // Steps left or ENGINE_UNLIMITED_STEPS.
+    bool paused;
+    bool quit;
+    bool done;
+    bool end_reached;
+} Engine;
+
+bool engine_start(
+        Engine *engine, enum SOLVERS solver,
+        Tree *root, Arena *arena, Maze *maze,
+        int32_t threads);
+
+void engine_grant(Engine *engine, int64_t steps);
+void engine_pause(Engine *engine, bool paused);
+bool engine_done(Engine *engine);
+void engine_lock_snapshot(Engine *engine);
+void engine_unlock_snapshot(Engine *engine);
+void engine_take_stats(Engine *engine, EngineStats *stats);
+bool engine_stop(Engine *engine);
+
+#endif // ENGINE_H
@@ -0,0 +1,440 @@
+// mkdir() isn't part of c99.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>      // fopen, fwrite, snprintf and perror.
+#include <stdlib.h>     // malloc and free.
+#include <string.h>     // strlen, strcmp and memcpy.
+#include <errno.h>      // EEXIST.
+#include <sys/stat.h>   // mkdir.
+#include "export.h"
+
+// Deflate stored blocks hold up to 65535 bytes.
+#define PNG_BLOCK_BYTES 65535
+
+static enum EXPORT_FORMATS export_format(const char *path);
+static void frame_dimensions(
+        enum EXPORT_FORMATS format, int32_t *width, int32_t *height);
+
+static size_t encoded_bytes(
+        enum EXPORT_FORMATS format, int32_t width, int32_t height);
+
+static void * export_loop(void *data);
+static bool write_png(Exporter *exporter, const uint32_t *pixels,
+        int64_t frame);
+static bool write_y4m(Exporter *exporter, const uint32_t *pixels);
+static uint8_t * put_chunk(uint8_t *out, const char *type,
+        const uint8_t *data, size_t size);
+static uint8_t * put_u32(uint8_t *out, uint32_t value);
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t size);
+
+static uint32_t crc_table[256];
+
+// Creates the directory of the PNG frames if needed, or the Y4M file with
+// its header, and starts the writer.
+bool export_open(
+        Exporter *exporter, const char *path,
+        int32_t width, int32_t height, int32_t fps)
+{
+    *exporter = (Exporter){0};
+    exporter -> path = path;
+    exporter -> fps = fps;
+    exporter -> format = export_format(path);
+    frame_dimensions(exporter -> format, &width, &height);
+    exporter -> encoded_size = encoded_bytes(exporter -> format, width, height);
+
+    for (uint32_t n = 0; n < 256; n++)
+    {
+        uint32_t crc = n;
+        for (int32_t bit = 0; bit < 8; bit++)
+        {
+            crc = crc & 1 ? 0xEDB88320u ^ crc >> 1 : crc >> 1;
+        }
+
+        crc_table[n] = crc;
+    }
+
+    if (exporter -> format == EXPORT_Y4M)
+    {
+        exporter -> file = fopen(path, "wb");
+        if (exporter -> file == NULL)
+        {
+            perror("Failed to open export file\n");
+            return false;
+        }
+
+        fprintf(exporter -> file, "YUV4MPEG2 W%"PRId32" H%"PRId32
+                " F%"PRId32":1 Ip A1:1 C420jpeg\n", width, height, fps);
+    }
+
+    else
+    {
+        if (mkdir(path, 0755) != 0 && errno != EEXIST)
+        {
+            perror("Failed to create export directory\n");
+            return false;
+        }
+    }
+
+    exporter -> width = width;
+    exporter -> height = height;
+    exporter -> frames = malloc(sizeof(uint32_t) * EXPORT_RING_FRAMES *
+            (size_t)width * height);
+    exporter -> encoded = malloc(exporter -> encoded_size);
+    if (exporter -> frames == NULL || exporter -> encoded == NULL)
+    {
+        perror("Failed to allocate memory for export\n");
+        free(exporter -> frames);
+        free(exporter -> encoded);
+        if (exporter -> file != NULL)
+        {
+            fclose(exporter -> file);
+        }
+
+        return false;
+    }
+
+    pthread_mutex_init(&exporter -> lock, NULL);
+    pthread_cond_init(&exporter -> wake, NULL);
+    pthread_cond_init(&exporter -> room, NULL);
+    if (pthread_create(&exporter -> thread, NULL, export_loop, exporter) != 0)
+    {
+        perror("Failed to create export thread\n");
+        pthread_cond_destroy(&exporter -> room);
+        pthread_cond_destroy(&exporter -> wake);
+        pthread_mutex_destroy(&exporter -> lock);
+        free(exporter -> frames);
+        free(exporter -> encoded);
+        if (exporter -> file != NULL)
+        {
+            fclose(exporter -> file);
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+// Bytes export_open() allocates for frames of width x height written on path:
+// the ring and a frame encoded.
+double export_memory(const char *path, int32_t width, int32_t height)
+{
+    enum EXPORT_FORMATS format = export_format(path);
+    frame_dimensions(format, &width, &height);
+    return (double)sizeof(uint32_t) * EXPORT_RING_FRAMES * width * height +
+        encoded_bytes(format, width, height);
+}
+
+// Next free slot of the ring, width x height pixels to draw the frame on.
+// Waits for the writer only if every slot is taken, NULL once a write failed.
+uint32_t * export_frame(Exporter *exporter)
+{
+    pthread_mutex_lock(&exporter -> lock);
+    while (!exporter -> failed && exporter -> count == EXPORT_RING_FRAMES)
+    {
+        pthread_cond_wait(&exporter -> room, &exporter -> lock);
+    }
+
+    size_t slot = (exporter -> first + exporter -> count) % EXPORT_RING_FRAMES;
+    bool failed = exporter -> failed;
+    pthread_mutex_unlock(&exporter -> lock);
+
+    if (failed)
+    {
+        return NULL;
+    }
+
+    return exporter -> frames +
+        slot * (size_t)exporter -> width * exporter -> height;
+}
+
+// Hands the slot of the last export_frame() to the writer.
+void export_push(Exporter *exporter)
+{
+    pthread_mutex_lock(&exporter -> lock);
+    exporter -> count += 1;
+    pthread_cond_signal(&exporter -> wake);
+    pthread_mutex_unlock(&exporter -> lock);
+}
+
+// Writes the frames left and closes the file, false if a write failed.
+bool export_close(Exporter *exporter, int64_t *written)
+{
+    pthread_mutex_lock(&exporter -> lock);
+    exporter -> quit = true;
+    pthread_cond_signal(&exporter -> wake);
+    pthread_mutex_unlock(&exporter -> lock);
+    pthread_join(exporter -> thread, NULL);
+
+    bool failed = exporter -> failed;
+    if (exporter -> file != NULL && fclose(exporter -> file) != 0)
+    {
+        perror("Failed to write export file\n");
+        failed = true;
+    }
+
+    pthread_cond_destroy(&exporter -> room);
+    pthread_cond_destroy(&exporter -> wake);
+    pthread_mutex_destroy(&exporter -> lock);
+    free(exporter -> frames);
+    free(exporter -> encoded);
+    *written = exporter -> written;
+    return !failed;
+}
+
+static enum EXPORT_FORMATS export_format(const char *path)
+{
+    size_t length = strlen(path);
+    size_t extension = strlen(EXPORT_Y4M_EXTENSION);
+    return length > extension &&
+        strcmp(path + length - extension, EXPORT_Y4M_EXTENSION) == 0 ?
+        EXPORT_Y4M : EXPORT_PNG;
+}
+
+// Chroma of Y4M is a sample per 2 x 2 pixels, so its frames are even.
+static void frame_dimensions(
+        enum EXPORT_FORMATS format, int32_t *width, int32_t *height)
+{
+    if (format == EXPORT_Y4M)
+    {
+        *width = *width < 2 ? 2 : *width & ~1;
+        *height = *height < 2 ? 2 : *height & ~1;
+    }
+}
+
+static size_t encoded_bytes(
+        enum EXPORT_FORMATS format, int32_t width, int32_t height)
+{
+    if (format == EXPORT_Y4M)
+    {
+        return (size_t)width * height * 3 / 2;
+    }
+
+    // Signature, IHDR, IDAT holding the stored zlib stream and IEND, then
+    // the raw rows.
+    size_t raw = (size_t)height * (1 + (size_t)width * 3);
+    return 8 + 25 + 12 + 2 + raw + 4 + 12 +
+        5 * ((raw + PNG_BLOCK_BYTES - 1) / PNG_BLOCK_BYTES) + raw;
+}
+
+// The frame stays on its slot while it's encoded, the solver only writes on
+// the slots after the taken ones.
+static void * export_loop(void *data)
+{
+    Exporter *exporter = data;
+    while (true)
+    {
+        pthread_mutex_lock(&exporter -> lock);
+        while (!exporter -> quit && exporter -> count == 0)
+        {
+            pthread_cond_wait(&exporter -> wake, &exporter -> lock);
+        }
+
+        if (exporter -> count == 0)
+        {
+            pthread_mutex_unlock(&exporter -> lock);
+            return NULL;
+        }
+
+        const uint32_t *pixels = exporter -> frames +
+            exporter -> first * (size_t)exporter -> width * exporter -> height;
+        int64_t frame = exporter -> written;
+        bool failed = exporter -> failed;
+        pthread_mutex_unlock(&exporter -> lock);
+
+        // After a failure the frames are only taken, so the solver can't get
+        // stuck on a full ring.
+        if (!failed)
+        {
+            failed = exporter -> format == EXPORT_Y4M ?
+                !write_y4m(exporter, pixels) :
+                !write_png(exporter, pixels, frame);
+        }
+
+        pthread_mutex_lock(&exporter -> lock);
+        exporter -> first = (exporter -> first + 1) % EXPORT_RING_FRAMES;
+        exporter -> count -= 1;
+        exporter -> written += !failed;
+        exporter -> failed = failed;
+        pthread_cond_signal(&exporter -> room);
+        pthread_mutex_unlock(&exporter -> lock);
+    }
+}
+
+// 8 bit RGB, the zlib stream is made of stored blocks so there's no
+// dependency on a deflate library. Recompress them if size matters.
+static bool write_png(Exporter *exporter, const uint32_t *pixels,
+        int64_t frame)
+{
+    int32_t width = exporter -> width;
+    int32_t height = exporter -> height;
+    size_t raw = (size_t)height * (1 + (size_t)width * 3);
+    uint8_t *out = exporter -> encoded;
+
+    static const uint8_t signature[] = {137, 'P', 'N', 'G', 13, 10, 26, 10};
+    memcpy(out, signature, sizeof(signature));
+    out += sizeof(signature);
+
+    uint8_t header[13];
+    put_u32(header, width);
+    put_u32(header + 4, height);
+    header[8] = 8;              // Bits per sample.
+    header[9] = 2;              // RGB.
+    header[10] = header[11] = header[12] = 0;
+    out = put_chunk(out, "IHDR", header, sizeof(header));
+
+    // IDAT is filled in place, its length and CRC are put around it after.
+    uint8_t *chunk = out;
+    uint8_t *data = chunk + 8;
+    uint8_t *zlib = data;
+    *zlib++ = 0x78;
+    *zlib++ = 0x01;
+
+    // Filtered rows (a 0 byte, no filter, and RGB) go on the scratch space
+    // after the PNG, then into stored blocks.
+    uint8_t *rows = exporter -> encoded + exporter -> encoded_size - raw;
+    uint8_t *row = rows;
+    for (int32_t y = 0; y < height; y++)
+    {
+        *row++ = 0;
+        for (int32_t x = 0; x < width; x++)
+        {
+            uint32_t pixel = pixels[(size_t)y * width + x];
+            *row++ = pixel >> 16;
+            *row++ = pixel >> 8;
+            *row++ = pixel;
+        }
+    }
+
+    // Sums of Adler-32 can take 5552 bytes before they could overflow.
+    uint32_t adler_a = 1, adler_b = 0;
+    for (size_t done = 0; done < raw; done += PNG_BLOCK_BYTES)
+    {
+        size_t block = raw - done < PNG_BLOCK_BYTES ?
+            raw - done : PNG_BLOCK_BYTES;
+
+        *zlib++ = done + block == raw;
+        *zlib++ = block & 0xFF;
+        *zlib++ = block >> 8;
+        *zlib++ = ~block & 0xFF;
+        *zlib++ = (~block >> 8) & 0xFF;
+        memcpy(zlib, rows + done, block);
+        for (size_t byte = 0; byte < block; byte++)
+        {
+            adler_a += zlib[byte];
+            adler_b += adler_a;
+            if (byte % 5552 == 5551)
+            {
+                adler_a %= 65521;
+                adler_b %= 65521;
+            }
+        }
+
+        adler_a %= 65521;
+        adler_b %= 65521;
+        zlib += block;
+    }
+
+    zlib = put_u32(zlib, adler_b << 16 | adler_a);
+    size_t size = zlib - data;
+    put_u32(chunk, size);
+    memcpy(chunk + 4, "IDAT", 4);
+    put_u32(zlib, crc32(0, chunk + 4, size + 4));
+    out = put_chunk(zlib + 4, "IEND", NULL, 0);
+
+    char name[4096];
+    snprintf(name, sizeof(name), "%s/frame-%06"PRId64".png",
+            exporter -> path, frame);
+
+    FILE *file = fopen(name, "wb");
+    if (file == NULL)
+    {
+        perror("Failed to open export frame\n");
+        return false;
+    }
+
+    size_t bytes = out - exporter -> encoded;
+    bool written = fwrite(exporter -> encoded, 1, bytes, file) == bytes;
+    if (fclose(file) != 0 || !written)
+    {
+        perror("Failed to write export frame\n");
+        return false;
+    }
+
+    return true;
+}
+
+// Full range BT.601 (what C420jpeg means), chroma averaged over 2 x 2 pixels.
+static bool write_y4m(Exporter *exporter, const uint32_t *pixels)
+{
+    int32_t width = exporter -> width;
+    int32_t height = exporter -> height;
+    uint8_t *luma = exporter -> encoded;
+    uint8_t *blue = luma + (size_t)width * height;
+    uint8_t *red = blue + (size_t)width * height / 4;
+
+    for (int32_t y = 0; y < height; y += 2)
+    {
+        for (int32_t x = 0; x < width; x += 2)
+        {
+            int32_t r = 0, g = 0, b = 0;
+            for (int32_t dy = 0; dy < 2; dy++)
+            {
+                for (int32_t dx = 0; dx < 2; dx++)
+                {
+                    size_t index = (size_t)(y + dy) * width + x + dx;
+                    int32_t pr = pixels[index] >> 16 & 0xFF;
+                    int32_t pg = pixels[index] >> 8 & 0xFF;
+                    int32_t pb = pixels[index] & 0xFF;
+                    luma[index] = (19595 * pr + 38470 * pg + 7471 * pb +
+                            32768) >> 16;
+                    r += pr, g += pg, b += pb;
+                }
+            }
+
+            size_t chroma = (size_t)y / 2 * (width / 2) + x / 2;
+            blue[chroma] = (-11059 * r - 21709 * g + 32768 * b +
+                    (128 << 18) + (1 << 17)) >> 18;
+            red[chroma] = (32768 * r - 27439 * g - 5329 * b +
+                    (128 << 18) + (1 << 17)) >> 18;
+        }
+    }
+
+    return fputs("FRAME\n", exporter -> file) != EOF &&
+        fwrite(exporter -> encoded, 1, exporter -> encoded_size,
+                exporter -> file) == exporter -> encoded_size;
+}
+
+static uint8_t * put_chunk(uint8_t *out, const char *type,
+        const uint8_t *data, size_t size)
+{
+    out = put_u32(out, size);
+    memcpy(out, type, 4);
+    if (size > 0)
+    {
+        memcpy(out + 4, data, size);
+    }
+
+    return put_u32(out + 4 + size, crc32(0, out, size + 4));
+}
+
+// Big endian, as everything on a PNG.
+static uint8_t * put_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = value >> 24;
+    out[1] = value >> 16;
+    out[2] = value >> 8;
+    out[3] = value;
+    return out + 4;
+}
+
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t size)
+{
+    crc = ~crc;
+    for (size_t byte = 0; byte < size; byte++)
+    {
+        crc = crc_table[(crc ^ data[byte]) & 0xFF] ^ crc >> 8;
+    }
+
+    return ~crc;
+}
@@ -0,0 +1,57 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include <stdio.h>      // FILE.
+#include <pthread.h>    // pthread_t, pthread_mutex_t and pthread_cond_t.
+
+// Frames drawn ahead of the writer, the solver only waits for it when all of
+// them are taken.
+#define EXPORT_RING_FRAMES 16
+
+// A path that ends on this is written as a single Y4M video, any other is a
+// directory of PNG frames.
+#define EXPORT_Y4M_EXTENSION ".y4m"
+
+enum EXPORT_FORMATS {EXPORT_PNG, EXPORT_Y4M};
+
+// Encodes and writes the frames on its own thread, the solving loop draws
+// each frame straight into a slot of the ring (export_frame()) and hands it
+// over (export_push()), so it never waits for the encoder nor the disk unless
+// the ring is full.
+typedef struct Exporter
+{
+    enum EXPORT_FORMATS format;
+    const char *path;
+    FILE *file;                 // EXPORT_Y4M.
+    int32_t width;
+    int32_t height;
+    int32_t fps;                // Written on the Y4M header.
+    uint32_t *frames;           // EXPORT_RING_FRAMES of ARGB8888 pixels.
+    uint8_t *encoded;           // Writer only, a frame as PNG or Y4M.
+    size_t encoded_size;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        // Of the writer, there's a frame or quit.
+    pthread_cond_t room;        // Of the solver, a slot was written.
+
+    // Guarded by lock.
+    size_t first;
+    size_t count;
+    int64_t written;
+    bool failed;
+    bool quit;
+} Exporter;
+
+bool export_open(
+        Exporter *exporter, const char *path,
+        int32_t width, int32_t height, int32_t fps);
+
+double export_memory(const char *path, int32_t width, int32_t height);
+uint32_t * export_frame(Exporter *exporter);
+void export_push(Exporter *exporter);
+bool export_close(Exporter *exporter, int64_t *written);
+
+#endif // EXPORT_H
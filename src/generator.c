@@ -0,0 +1,745 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc, calloc and free.
+#include <stdint.h>     // SIZE_MAX.
+#include <string.h>     // memset.
+#include "generator.h"
+#include "maze-file.h"  // Packed rows written by eller_stream().
+#include "grid-kernels.h"   // Bulk fill and replace of the grid.
+#include "solver.h"     // MAZE_MOVES.
+
+// Rows state of eller(), everything is per column of carved cells.
+typedef struct EllerRows
+{
+    size_t columns;
+    size_t *sets;
+    size_t *next_sets;
+    size_t *next_roots;
+    size_t *remaining;
+    bool *went_down;
+    bool *right;
+    bool *down;
+} EllerRows;
+
+static bool carve_maze(Maze *maze, enum GENERATORS generator, Rng *rng);
+static void maze_grid(Maze *maze);
+static void maze_set_ends(Maze *maze);
+static size_t carved_index(const Maze *maze, size_t cell);
+static size_t find_set(size_t *sets, size_t cell);
+static bool eller_init(EllerRows *eller, size_t columns);
+static void eller_row(EllerRows *eller, Rng *rng, bool last_row);
+static void eller_free(EllerRows *eller);
+static enum MAZE_MOVES random_move(
+        const Maze *maze, int32_t x, int32_t y,
+        Rng *rng);
+
+// Same names as --generator.
+const char * generator_name(enum GENERATORS generator)
+{
+    switch (generator)
+    {
+        case GENERATOR_BACKTRACKER:
+            return "backtracker";
+
+        case GENERATOR_KRUSKAL:
+            return "kruskal";
+
+        case GENERATOR_WILSON:
+            return "wilson";
+
+        case GENERATOR_ELLER:
+            return "eller";
+
+        default:
+            return "unknown";
+    }
+}
+
+// Every generator draws only from rng, the same state gives the same maze.
+Maze * generate_maze(
+        enum GENERATORS generator,
+        int32_t rows, int32_t columns,
+        Rng *rng)
+{
+    Maze * maze = maze_create(rows - (rows % 2 == 0),
+                                columns - (columns % 2 == 0));
+    if (maze == NULL)
+    {
+        return NULL;
+    }
+
+    if (!carve_maze(maze, generator, rng))
+    {
+        maze_free(maze);
+        return NULL;
+    }
+
+    return maze;
+}
+
+// Carves a new maze on the grid of one from generate_maze(), reusing its
+// memory: what a solver left on it is wiped. Same maze as generate_maze() for
+// the same rng.
+bool generate_maze_on(Maze *maze, enum GENERATORS generator, Rng *rng)
+{
+    memset(maze -> distances_runned, 0,
+            sizeof(uint32_t) * maze_cells(maze));
+
+    return carve_maze(maze, generator, rng);
+}
+
+bool recursive_backtracker(Maze *maze, Rng *rng)
+{
+    maze_grid(maze);
+
+    // Only cells with even coordinates are carved (pushed) into backtrack.
+    size_t max_size =
+        (size_t)(maze -> rows / 2 + 1) * (maze -> columns / 2 + 1);
+    size_t *backtrack = malloc(sizeof(size_t) * max_size);
+    if (backtrack == NULL)
+    {
+        perror("Failed to allocate memory for backtrack\n");
+        return false;
+    }
+
+    size_t backtrack_size = 1;
+    backtrack[0] = maze_index(maze, 0, 0);
+    maze -> types[backtrack[0]] = VISITED;
+
+    // VALID and INVALID moves that a cell can do.
+    enum MAZE_MOVES moves[] = {LEFT, UP, DOWN, RIGHT};
+    size_t pos_move_quantity = sizeof(moves) / sizeof(enum MAZE_MOVES);
+
+    // Moves that actually the user can do
+    enum MAZE_MOVES valid_moves[] = {-1, -1, -1, -1};
+    size_t valid_moves_count = 0;
+
+    // Offsets on the flat grid of each move, the wall is the block between
+    // current and new cell.
+    ptrdiff_t wall_offset[] =
+    {
+        [LEFT] = -1,
+        [RIGHT] = 1,
+        [UP] = -(ptrdiff_t)maze -> columns,
+        [DOWN] = maze -> columns
+    };
+
+    size_t current;
+    int32_t current_x;
+    int32_t current_y;
+    size_t new;
+
+    do
+    {
+        valid_moves_count = 0;
+        current = backtrack[backtrack_size - 1];
+        current_x = maze_index_x(maze, current);
+        current_y = maze_index_y(maze, current);
+
+        for (size_t move = 0; move < pos_move_quantity; move++)
+        {
+            // Checking for out of bounds
+            if ((moves[move] == LEFT && current_x <= 0) ||
+                (moves[move] == RIGHT &&
+                    current_x >= maze -> columns - 1) ||
+                (moves[move] == UP && current_y <= 0) ||
+                (moves[move] == DOWN && current_y >= maze -> rows - 1))
+            {
+                continue;
+            }
+
+            new = current + 2 * wall_offset[moves[move]];
+            if (maze -> types[new] == EMPTY)
+            {
+                valid_moves[valid_moves_count] = moves[move];
+                valid_moves_count++;
+            }
+        }
+
+        if (valid_moves_count == 0)
+        {
+            backtrack_size--;
+        }
+
+        else
+        {
+            enum MAZE_MOVES mv = valid_moves[
+                                    rng_below(rng, valid_moves_count)];
+
+            new = current + 2 * wall_offset[mv];
+            backtrack[backtrack_size] = new;
+            maze -> types[new] = VISITED;
+            maze -> types[current + wall_offset[mv]] = EMPTY;
+            backtrack_size++;
+        }
+    }
+    while (backtrack_size > 1);
+
+    // Set the visited cells used for backtracking to empty cells.
+    grid_replace(maze -> types, maze_cells(maze), VISITED, EMPTY);
+
+    free(backtrack);
+    maze_set_ends(maze);
+    return true;
+}
+
+// Walls between two carved cells are knocked down in random order, unless
+// both cells are already connected (same set) since that would make a loop.
+bool kruskal(Maze *maze, Rng *rng)
+{
+    maze_grid(maze);
+
+    size_t carved_rows = maze -> rows / 2 + 1;
+    size_t carved_columns = maze -> columns / 2 + 1;
+    size_t carved = carved_rows * carved_columns;
+    size_t edges_count = carved_rows * (carved_columns - 1) +
+                         (carved_rows - 1) * carved_columns;
+
+    // One more so a 1x1 maze doesn't ask malloc for 0 bytes.
+    size_t *edges = malloc(sizeof(size_t) * (edges_count + 1));
+    size_t *sets = malloc(sizeof(size_t) * carved);
+    if (edges == NULL || sets == NULL)
+    {
+        perror("Failed to allocate memory for kruskal edges\n");
+        free(edges);
+        free(sets);
+        return false;
+    }
+
+    // A wall with one odd and one even coordinate lies between two carved
+    // cells, the ones with both odd are corners.
+    size_t edge = 0;
+    size_t cell = 0;
+    for (int32_t row = 0; row < maze -> rows; row++)
+    {
+        for (int32_t column = 0; column < maze -> columns; column++, cell++)
+        {
+            if (row % 2 != column % 2)
+            {
+                edges[edge++] = cell;
+            }
+        }
+    }
+
+    for (size_t set = 0; set < carved; set++)
+    {
+        sets[set] = set;
+    }
+
+    // Fisher-Yates shuffle.
+    for (edge = edges_count; edge > 1; edge--)
+    {
+        size_t other = rng_below(rng, edge);
+        size_t wall = edges[edge - 1];
+        edges[edge - 1] = edges[other];
+        edges[other] = wall;
+    }
+
+    // A spanning tree has exactly carved - 1 passages.
+    size_t passages = 0;
+    for (edge = 0; edge < edges_count && passages + 1 < carved; edge++)
+    {
+        size_t wall = edges[edge];
+        size_t step = maze_index_y(maze, wall) % 2 == 0 ?
+            1 : (size_t)maze -> columns;
+
+        size_t a = find_set(sets, carved_index(maze, wall - step));
+        size_t b = find_set(sets, carved_index(maze, wall + step));
+        if (a != b)
+        {
+            sets[a] = b;
+            maze -> types[wall] = EMPTY;
+            passages++;
+        }
+    }
+
+    free(edges);
+    free(sets);
+    maze_set_ends(maze);
+    return true;
+}
+
+// Random walks from every cell not yet in the maze until they hit it, only
+// the last move out of each cell is remembered so the loops the walk made are
+// erased when the path is carved. Every spanning tree is equally likely.
+bool wilson(Maze *maze, Rng *rng)
+{
+    maze_grid(maze);
+
+    size_t carved_columns = maze -> columns / 2 + 1;
+    size_t carved = (size_t)(maze -> rows / 2 + 1) * carved_columns;
+    uint8_t *walk = malloc(sizeof(uint8_t) * carved);
+    if (walk == NULL)
+    {
+        perror("Failed to allocate memory for wilson walk\n");
+        return false;
+    }
+
+    ptrdiff_t wall_offset[] =
+    {
+        [LEFT] = -1,
+        [RIGHT] = 1,
+        [UP] = -(ptrdiff_t)maze -> columns,
+        [DOWN] = maze -> columns
+    };
+
+    // VISITED cells are the ones already in the maze, it starts with one.
+    size_t first = rng_below(rng, carved);
+    maze -> types[maze_index(maze,
+            2 * (first % carved_columns), 2 * (first / carved_columns))] =
+        VISITED;
+
+    for (int32_t row = 0; row < maze -> rows; row += 2)
+    {
+        for (int32_t column = 0; column < maze -> columns; column += 2)
+        {
+            size_t start = maze_index(maze, column, row);
+            size_t current = start;
+            int32_t x = column;
+            int32_t y = row;
+            while (maze -> types[current] != VISITED)
+            {
+                enum MAZE_MOVES mv = random_move(maze, x, y, rng);
+                walk[carved_index(maze, current)] = mv;
+                current += 2 * wall_offset[mv];
+                x += mv == LEFT ? -2 : mv == RIGHT ? 2 : 0;
+                y += mv == UP ? -2 : mv == DOWN ? 2 : 0;
+            }
+
+            for (current = start; maze -> types[current] != VISITED;)
+            {
+                enum MAZE_MOVES mv = walk[carved_index(maze, current)];
+                maze -> types[current] = VISITED;
+                maze -> types[current + wall_offset[mv]] = EMPTY;
+                current += 2 * wall_offset[mv];
+            }
+        }
+    }
+
+    grid_replace(maze -> types, maze_cells(maze), VISITED, EMPTY);
+    free(walk);
+    maze_set_ends(maze);
+    return true;
+}
+
+// Carves a row at a time keeping only which cells of the current row are
+// already connected (sets, a union find over its columns):
+//  - Neighbours on different sets are randomly joined, on the last row all of
+//    them are so everything ends connected.
+//  - Every set goes down atleast once, the cells that don't go down start on
+//    a set of their own on the next row.
+bool eller(Maze *maze, Rng *rng)
+{
+    maze_grid(maze);
+
+    EllerRows eller;
+    if (!eller_init(&eller, maze -> columns / 2 + 1))
+    {
+        return false;
+    }
+
+    for (int32_t row = 0; row < maze -> rows; row += 2)
+    {
+        eller_row(&eller, rng, row == maze -> rows - 1);
+        for (size_t column = 0; column < eller.columns; column++)
+        {
+            if (eller.right[column])
+            {
+                maze -> types[maze_index(maze, 2 * column + 1, row)] = EMPTY;
+            }
+
+            if (eller.down[column])
+            {
+                maze -> types[maze_index(maze, 2 * column, row + 1)] = EMPTY;
+            }
+        }
+    }
+
+    eller_free(&eller);
+    maze_set_ends(maze);
+    return true;
+}
+
+// Same maze as eller() but each row goes to the maze file at path as soon as
+// it's carved, only the rows state is in memory so the maze can be bigger
+// than it.
+bool eller_stream(
+        const char *path,
+        int32_t rows, int32_t columns,
+        Rng *rng, uint64_t seed)
+{
+    rows -= (rows % 2 == 0);
+    columns -= (columns % 2 == 0);
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        perror("Failed to create maze file\n");
+        return false;
+    }
+
+    MazeFileHeader header;
+    maze_file_header(&header, rows, columns, GENERATOR_ELLER, seed);
+
+    EllerRows eller;
+    size_t row_bytes = maze_file_row_bytes(columns);
+    uint8_t *packed = malloc(row_bytes);
+    if (packed == NULL || !eller_init(&eller, columns / 2 + 1))
+    {
+        perror("Failed to allocate memory for eller rows\n");
+        free(packed);
+        fclose(file);
+        return false;
+    }
+
+    bool written = maze_file_write_header(file, &header);
+    for (int32_t row = 0; row < rows && written; row += 2)
+    {
+        eller_row(&eller, rng, row == rows - 1);
+        memset(packed, 0, row_bytes);
+        for (size_t column = 0; column < eller.columns; column++)
+        {
+            maze_file_set_walls(packed, column,
+                    (eller.right[column] ? 0 : MAZE_FILE_WALL_RIGHT) |
+                    (eller.down[column] ? 0 : MAZE_FILE_WALL_DOWN));
+        }
+
+        written = fwrite(packed, row_bytes, 1, file) == 1;
+    }
+
+    if (!written)
+    {
+        perror("Failed to write maze file\n");
+    }
+
+    eller_free(&eller);
+    free(packed);
+    return fclose(file) == 0 && written;
+}
+
+double generator_scratch_memory(
+        enum GENERATORS generator,
+        int32_t rows, int32_t columns)
+{
+    rows -= (rows % 2 == 0);
+    columns -= (columns % 2 == 0);
+
+    double carved_columns = columns / 2 + 1;
+    double carved = (double)(rows / 2 + 1) * carved_columns;
+    switch (generator)
+    {
+        case GENERATOR_KRUSKAL:
+            // Edges (about 2 per cell) and sets.
+            return 3 * carved * sizeof(size_t);
+
+        case GENERATOR_WILSON:
+            return carved * sizeof(uint8_t);
+
+        case GENERATOR_ELLER:
+            return carved_columns * (4 * sizeof(size_t) + 3 * sizeof(bool));
+
+        default:
+            return carved * sizeof(size_t);
+    }
+}
+
+// A perfect maze is a spanning tree of its open cells: one passage less than
+// open cells and every open cell reachable from START.
+bool maze_is_perfect(const Maze *maze)
+{
+    size_t open = 0;
+    size_t passages = 0;
+    size_t cell = 0;
+    for (int32_t row = 0; row < maze -> rows; row++)
+    {
+        for (int32_t column = 0; column < maze -> columns; column++, cell++)
+        {
+            if (maze -> types[cell] == WALL)
+            {
+                continue;
+            }
+
+            open++;
+            passages += column + 1 < maze -> columns &&
+                        maze -> types[cell + 1] != WALL;
+            passages += row + 1 < maze -> rows &&
+                        maze -> types[cell + maze -> columns] != WALL;
+        }
+    }
+
+    if (open == 0 || passages != open - 1)
+    {
+        return false;
+    }
+
+    size_t *queue = malloc(sizeof(size_t) * open);
+    uint8_t *reached = calloc(maze_cells(maze) / 8 + 1, sizeof(uint8_t));
+    if (queue == NULL || reached == NULL)
+    {
+        perror("Failed to allocate memory for maze check\n");
+        free(queue);
+        free(reached);
+        return false;
+    }
+
+    size_t queue_begin = 0;
+    size_t queue_end = 0;
+    size_t start = maze_index(maze, maze -> start_x, maze -> start_y);
+    queue[queue_end++] = start;
+    reached[start / 8] |= 1 << (start % 8);
+    while (queue_begin < queue_end)
+    {
+        cell = queue[queue_begin++];
+        int32_t x = maze_index_x(maze, cell);
+        int32_t y = maze_index_y(maze, cell);
+        size_t neighbours[MAX_MOVES];
+        size_t neighbours_count = 0;
+        if (x > 0)
+        {
+            neighbours[neighbours_count++] = cell - 1;
+        }
+
+        if (x < maze -> columns - 1)
+        {
+            neighbours[neighbours_count++] = cell + 1;
+        }
+
+        if (y > 0)
+        {
+            neighbours[neighbours_count++] = cell - maze -> columns;
+        }
+
+        if (y < maze -> rows - 1)
+        {
+            neighbours[neighbours_count++] = cell + maze -> columns;
+        }
+
+        for (size_t i = 0; i < neighbours_count; i++)
+        {
+            size_t next = neighbours[i];
+            if (maze -> types[next] != WALL &&
+                    !(reached[next / 8] & (1 << (next % 8))))
+            {
+                reached[next / 8] |= 1 << (next % 8);
+                queue[queue_end++] = next;
+            }
+        }
+    }
+
+    free(queue);
+    free(reached);
+    return queue_end == open;
+}
+
+static bool carve_maze(Maze *maze, enum GENERATORS generator, Rng *rng)
+{
+    switch (generator)
+    {
+        case GENERATOR_KRUSKAL:
+            return kruskal(maze, rng);
+
+        case GENERATOR_WILSON:
+            return wilson(maze, rng);
+
+        case GENERATOR_ELLER:
+            return eller(maze, rng);
+
+        default:
+            return recursive_backtracker(maze, rng);
+    }
+}
+
+// Cells with even coordinates are left EMPTY to be carved, the rest are
+// walls.
+static void maze_grid(Maze *maze)
+{
+    // Odd rows are all walls, even ones alternate carved cells and walls.
+    for (int32_t row = 0; row < maze -> rows; row++)
+    {
+        uint8_t *cells = maze -> types + maze_index(maze, 0, row);
+        if (row % 2)
+        {
+            grid_fill(cells, maze -> columns, WALL);
+        }
+        else
+        {
+            grid_fill_alternating(cells, maze -> columns, EMPTY, WALL);
+        }
+    }
+}
+
+// Setting start and end of the maze.
+// Start is top left corner
+// End is bottom right corner.
+static void maze_set_ends(Maze *maze)
+{
+    maze -> start_x = 0;
+    maze -> start_y = 0;
+    maze -> end_x = maze -> columns - 1;
+    maze -> end_y = maze -> rows - 1;
+    maze -> types[maze_index(maze, maze -> start_x, maze -> start_y)] = START;
+    maze -> types[maze_index(maze, maze -> end_x, maze -> end_y)] = END;
+}
+
+static bool eller_init(EllerRows *eller, size_t columns)
+{
+    eller -> columns = columns;
+    eller -> sets = malloc(sizeof(size_t) * columns);
+    eller -> next_sets = malloc(sizeof(size_t) * columns);
+    eller -> next_roots = malloc(sizeof(size_t) * columns);
+    eller -> remaining = malloc(sizeof(size_t) * columns);
+    eller -> went_down = malloc(sizeof(bool) * columns);
+    eller -> right = malloc(sizeof(bool) * columns);
+    eller -> down = malloc(sizeof(bool) * columns);
+    if (eller -> sets == NULL || eller -> next_sets == NULL ||
+            eller -> next_roots == NULL || eller -> remaining == NULL ||
+            eller -> went_down == NULL || eller -> right == NULL ||
+            eller -> down == NULL)
+    {
+        perror("Failed to allocate memory for eller sets\n");
+        eller_free(eller);
+        return false;
+    }
+
+    for (size_t column = 0; column < columns; column++)
+    {
+        eller -> sets[column] = column;
+    }
+
+    return true;
+}
+
+// Decides the passages of the next row: right[column] to the cell on its
+// right and down[column] to the cell below, then moves the sets down.
+static void eller_row(EllerRows *eller, Rng *rng, bool last_row)
+{
+    size_t *sets = eller -> sets;
+    size_t columns = eller -> columns;
+    for (size_t column = 0; column < columns; column++)
+    {
+        eller -> right[column] = false;
+        eller -> down[column] = false;
+    }
+
+    for (size_t column = 0; column + 1 < columns; column++)
+    {
+        size_t a = find_set(sets, column);
+        size_t b = find_set(sets, column + 1);
+        if (a != b && (last_row || rng_bit(rng)))
+        {
+            sets[b] = a;
+            eller -> right[column] = true;
+        }
+    }
+
+    if (last_row)
+    {
+        return;
+    }
+
+    for (size_t column = 0; column < columns; column++)
+    {
+        eller -> remaining[column] = 0;
+        eller -> went_down[column] = false;
+        eller -> next_roots[column] = SIZE_MAX;
+    }
+
+    for (size_t column = 0; column < columns; column++)
+    {
+        eller -> remaining[find_set(sets, column)]++;
+    }
+
+    // The last cell of a set that hasn't gone down yet must go.
+    for (size_t column = 0; column < columns; column++)
+    {
+        size_t root = find_set(sets, column);
+        eller -> remaining[root]--;
+        eller -> down[column] = rng_bit(rng) ||
+            (eller -> remaining[root] == 0 && !eller -> went_down[root]);
+
+        if (eller -> down[column])
+        {
+            eller -> went_down[root] = true;
+        }
+    }
+
+    // The first cell of a set that went down is the root of its set on the
+    // next row.
+    for (size_t column = 0; column < columns; column++)
+    {
+        eller -> next_sets[column] = column;
+        if (eller -> down[column])
+        {
+            size_t root = find_set(sets, column);
+            if (eller -> next_roots[root] == SIZE_MAX)
+            {
+                eller -> next_roots[root] = column;
+            }
+
+            eller -> next_sets[column] = eller -> next_roots[root];
+        }
+    }
+
+    eller -> sets = eller -> next_sets;
+    eller -> next_sets = sets;
+}
+
+static void eller_free(EllerRows *eller)
+{
+    free(eller -> sets);
+    free(eller -> next_sets);
+    free(eller -> next_roots);
+    free(eller -> remaining);
+    free(eller -> went_down);
+    free(eller -> right);
+    free(eller -> down);
+}
+
+// Index of a carved cell among carved cells only.
+static size_t carved_index(const Maze *maze, size_t cell)
+{
+    return (size_t)(maze_index_y(maze, cell) / 2) * (maze -> columns / 2 + 1) +
+           maze_index_x(maze, cell) / 2;
+}
+
+// Path halving: every node visited is pointed to its grandparent, so trees
+// stay flat without a second pass.
+static size_t find_set(size_t *sets, size_t cell)
+{
+    while (sets[cell] != cell)
+    {
+        sets[cell] = sets[sets[cell]];
+        cell = sets[cell];
+    }
+
+    return cell;
+}
+
+// Any move from a carved cell to another that stays inside the maze.
+static enum MAZE_MOVES random_move(
+        const Maze *maze, int32_t x, int32_t y,
+        Rng *rng)
+{
+    enum MAZE_MOVES valid_moves[MAX_MOVES];
+    int valid_moves_count = 0;
+    if (x > 0)
+    {
+        valid_moves[valid_moves_count++] = LEFT;
+    }
+
+    if (y > 0)
+    {
+        valid_moves[valid_moves_count++] = UP;
+    }
+
+    if (y < maze -> rows - 1)
+    {
+        valid_moves[valid_moves_count++] = DOWN;
+    }
+
+    if (x < maze -> columns - 1)
+    {
+        valid_moves[valid_moves_count++] = RIGHT;
+    }
+
+    return valid_moves[rng_below(rng, valid_moves_count)];
+}
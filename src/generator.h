@@ -0,0 +1,51 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "rng.h"        // Rng, state of the random numbers.
+
+// Every generator carves the cells with even coordinates and the walls
+// between them, the result is a perfect maze (exactly one path between any
+// two cells) with START on the top left corner and END on the bottom right.
+// X O X O X
+// O O O O O
+// X O X O X
+// Even rows or columns get substracted by 1.
+enum GENERATORS
+{
+    GENERATOR_BACKTRACKER,  // Long winding corridors, few junctions.
+    GENERATOR_KRUSKAL,      // Many short dead ends.
+    GENERATOR_WILSON,       // Uniform spanning tree, unbiased.
+    GENERATOR_ELLER,        // Row by row, memory only per row.
+};
+
+const char * generator_name(enum GENERATORS generator);
+Maze * generate_maze(
+        enum GENERATORS generator,
+        int32_t rows, int32_t columns,
+        Rng *rng);
+
+bool generate_maze_on(Maze *maze, enum GENERATORS generator, Rng *rng);
+
+// Carve the maze on a grid of odd rows and columns, false if there's no
+// memory for their scratch.
+bool recursive_backtracker(Maze *maze, Rng *rng);
+bool kruskal(Maze *maze, Rng *rng);
+bool wilson(Maze *maze, Rng *rng);
+bool eller(Maze *maze, Rng *rng);
+bool eller_stream(
+        const char *path,
+        int32_t rows, int32_t columns,
+        Rng *rng, uint64_t seed);
+
+// Bytes used while generating besides the maze itself, all freed before the
+// maze is returned.
+double generator_scratch_memory(
+        enum GENERATORS generator,
+        int32_t rows, int32_t columns);
+
+bool maze_is_perfect(const Maze *maze);
+
+#endif // GENERATOR_H
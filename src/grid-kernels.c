@@ -0,0 +1,658 @@
+#include <string.h>     // memset.
+#include <pthread.h>    // pthread_once.
+#include "grid-kernels.h"
+
+// SSE2 and AVX2 versions are compiled for their instruction set with the
+// target attribute, so the rest of the program keeps the default flags and
+// still runs on any x86 CPU.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GRID_KERNELS_X86
+#include <immintrin.h>  // SSE2 and AVX2 intrinsics.
+#endif
+
+typedef struct GridKernels
+{
+    void (*fill_alternating)(uint8_t*, size_t, uint8_t, uint8_t);
+    void (*replace)(uint8_t*, size_t, uint8_t, uint8_t);
+    void (*count)(const uint8_t*, size_t, size_t*);
+    uint32_t (*max_distance)(const uint8_t*, const uint32_t*, size_t,
+            uint16_t);
+    void (*bits)(const uint8_t*, size_t, uint16_t, uint64_t*);
+} GridKernels;
+
+static void fill_alternating_portable(
+        uint8_t *cells, size_t count,
+        uint8_t even, uint8_t odd);
+
+static void replace_portable(
+        uint8_t *cells, size_t count,
+        uint8_t from, uint8_t to);
+
+static void count_portable(const uint8_t *types, size_t count, size_t *counts);
+static uint32_t max_distance_portable(
+        const uint8_t *types, const uint32_t *distances, size_t count,
+        uint16_t type_mask);
+
+static void bits_portable(
+        const uint8_t *types, size_t count,
+        uint16_t type_mask, uint64_t *bits);
+
+#ifdef GRID_KERNELS_X86
+static uint16_t compared_types(uint16_t type_mask, bool *inverted);
+static void fill_alternating_sse2(
+        uint8_t *cells, size_t count,
+        uint8_t even, uint8_t odd);
+
+static void replace_sse2(
+        uint8_t *cells, size_t count,
+        uint8_t from, uint8_t to);
+
+static void count_sse2(const uint8_t *types, size_t count, size_t *counts);
+static uint32_t max_distance_sse2(
+        const uint8_t *types, const uint32_t *distances, size_t count,
+        uint16_t type_mask);
+
+static void bits_sse2(
+        const uint8_t *types, size_t count,
+        uint16_t type_mask, uint64_t *bits);
+
+static void fill_alternating_avx2(
+        uint8_t *cells, size_t count,
+        uint8_t even, uint8_t odd);
+
+static void replace_avx2(
+        uint8_t *cells, size_t count,
+        uint8_t from, uint8_t to);
+
+static void count_avx2(const uint8_t *types, size_t count, size_t *counts);
+static uint32_t max_distance_avx2(
+        const uint8_t *types, const uint32_t *distances, size_t count,
+        uint16_t type_mask);
+
+static void bits_avx2(
+        const uint8_t *types, size_t count,
+        uint16_t type_mask, uint64_t *bits);
+#endif
+
+static const GridKernels kernels_table[GRID_KERNELS_COUNT] =
+{
+    [GRID_KERNELS_PORTABLE] =
+    {
+        fill_alternating_portable, replace_portable,
+        count_portable, max_distance_portable, bits_portable
+    },
+#ifdef GRID_KERNELS_X86
+    [GRID_KERNELS_SSE2] =
+    {
+        fill_alternating_sse2, replace_sse2,
+        count_sse2, max_distance_sse2, bits_sse2
+    },
+    [GRID_KERNELS_AVX2] =
+    {
+        fill_alternating_avx2, replace_avx2,
+        count_avx2, max_distance_avx2, bits_avx2
+    },
+#endif
+};
+
+// The best version is picked once, by whichever thread gets here first: the
+// jobs of a batch all generate mazes at the same time.
+static const GridKernels *kernels = NULL;
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+static void pick_kernels(void)
+{
+    enum GRID_KERNELS best = GRID_KERNELS_PORTABLE;
+    for (enum GRID_KERNELS k = GRID_KERNELS_SSE2; k < GRID_KERNELS_COUNT; k++)
+    {
+        if (grid_kernels_supported(k))
+        {
+            best = k;
+        }
+    }
+
+    kernels = &kernels_table[best];
+}
+
+static const GridKernels * grid_kernels(void)
+{
+    pthread_once(&kernels_once, pick_kernels);
+    return kernels;
+}
+
+const char * grid_kernels_name(enum GRID_KERNELS kernels)
+{
+    switch (kernels)
+    {
+        case GRID_KERNELS_PORTABLE:
+            return "portable";
+
+        case GRID_KERNELS_SSE2:
+            return "sse2";
+
+        case GRID_KERNELS_AVX2:
+            return "avx2";
+
+        default:
+            return "unknown";
+    }
+}
+
+bool grid_kernels_supported(enum GRID_KERNELS kernels)
+{
+    switch (kernels)
+    {
+        case GRID_KERNELS_PORTABLE:
+            return true;
+
+#ifdef GRID_KERNELS_X86
+        case GRID_KERNELS_SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+
+        case GRID_KERNELS_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+
+        default:
+            return false;
+    }
+}
+
+// Forces a version instead of the best one, for benchmarks. False if the CPU
+// doesn't support it. Not to be called while other threads use the kernels.
+bool grid_kernels_use(enum GRID_KERNELS kernels_wanted)
+{
+    if (!grid_kernels_supported(kernels_wanted))
+    {
+        return false;
+    }
+
+    pthread_once(&kernels_once, pick_kernels);
+    kernels = &kernels_table[kernels_wanted];
+    return true;
+}
+
+// memset is already vectorized by the C library.
+void grid_fill(uint8_t *cells, size_t count, uint8_t value)
+{
+    memset(cells, value, count);
+}
+
+// even, odd, even, odd... as the rows with carved cells of a new maze.
+void grid_fill_alternating(
+        uint8_t *cells, size_t count,
+        uint8_t even, uint8_t odd)
+{
+    grid_kernels() -> fill_alternating(cells, count, even, odd);
+}
+
+void grid_replace(uint8_t *cells, size_t count, uint8_t from, uint8_t to)
+{
+    grid_kernels() -> replace(cells, count, from, to);
+}
+
+// Cells of each type, counts must hold GRID_TYPES. Types from GRID_TYPES on
+// aren't counted.
+void grid_count(const uint8_t *types, size_t count, size_t *counts)
+{
+    for (size_t type = 0; type < GRID_TYPES; type++)
+    {
+        counts[type] = 0;
+    }
+
+    grid_kernels() -> count(types, count, counts);
+}
+
+// Highest distance of the cells whose type has its bit set on type_mask, 0 if
+// there's none.
+uint32_t grid_max_distance(
+        const uint8_t *types, const uint32_t *distances, size_t count,
+        uint16_t type_mask)
+{
+    return grid_kernels() -> max_distance(types, distances, count, type_mask);
+}
+
+// Bit i of bits is set if the type of cell i is on type_mask, bits holds
+// count cells rounded up to words of 64.
+void grid_bits(
+        const uint8_t *types, size_t count,
+        uint16_t type_mask, uint64_t *bits)
+{
+    grid_kernels() -> bits(types, count, type_mask, bits);
+}
+
+static void fill_alternating_portable(
+        uint8_t *cells, size_t count,
+        uint8_t even, uint8_t odd)
+{
+    for (size_t cell = 0; cell < count; cell++)
+    {
+        cells[cell] = cell % 2 ? odd : even;
+    }
+}
+
+static void replace_portable(
+        uint8_t *cells, size_t count,
+        uint8_t from, uint8_t to)
+{
+    for (size_t cell = 0; cell < count; cell++)
+    {
+        cells[cell] = cells[cell] == from ? to : cells[cell];
+    }
+}
+
+// Four histograms so consecutive cells of the same type don't wait on each
+// other's increment.
+static void count_portable(const uint8_t *types, size_t count, size_t *counts)
+{
+    size_t histograms[4][UINT8_MAX + 1] = {{0}};
+    size_t cell = 0;
+    for (; cell + 4 <= count; cell += 4)
+    {
+        histograms[0][types[cell]] += 1;
+        histograms[1][types[cell + 1]] += 1;
+        histograms[2][types[cell + 2]] += 1;
+        histograms[3][types[cell + 3]] += 1;
+    }
+
+    for (; cell < count; cell++)
+    {
+        histograms[0][types[cell]] += 1;
+    }
+
+    for (size_t type = 0; type < GRID_TYPES; type++)
+    {
+        counts[type] += histograms[0][type] + histograms[1][type] +
+            histograms[2][type] + histograms[3][type];
+    }
+}
+
+// Branchless, the distance of a cell is kept or cleared by a mask per type.
+static uint32_t max_distance_portable(
+        const uint8_t *types, const uint32_t *distances, size_t count,
+        uint16_t type_mask)
+{
+    uint32_t keep[UINT8_MAX + 1] = {0};
+    for (size_t type = 0; type < GRID_TYPES; type++)
+    {
+        keep[type] = type_mask >> type & 1 ? UINT32_MAX : 0;
+    }
+
+    uint32_t max = 0;
+    for (size_t cell = 0; cell < count; cell++)
+    {
+        uint32_t distance = distances[cell] & keep[types[cell]];
+        max = distance > max ? distance : max;
+    }
+
+    return max;
+}
+
+static void bits_portable(
+        const uint8_t *types, size_t count,
+        uint16_t type_mask, uint64_t *bits)
+{
+    for (size_t word = 0; word * 64 < count; word++)
+    {
+        size_t cells = count - word * 64 < 64 ? count - word * 64 : 64;
+        uint64_t value = 0;
+        for (size_t bit = 0; bit < cells; bit++)
+        {
+            uint8_t type = types[word * 64 + bit];
+            value |= (uint64_t)(type < GRID_TYPES &&
+                    type_mask >> type & 1) << bit;
+        }
+
+        bits[word] = value;
+    }
+}
+
+#ifdef GRID_KERNELS_X86
+__attribute__((target("sse2")))
+static void fill_alternating_sse2(
+        uint8_t *cells, size_t count,
+        uint8_t even, uint8_t odd)
+{
+    __m128i pattern = _mm_set1_epi16((int16_t)(even | odd << 8));
+    size_t cell = 0;
+    for (; cell + 16 <= count; cell += 16)
+    {
+        _mm_storeu_si128((__m128i*)(cells + cell), pattern);
+    }
+
+    fill_alternating_portable(cells + cell, count - cell, even, odd);
+}
+
+__attribute__((target("sse2")))
+static void replace_sse2(
+        uint8_t *cells, size_t count,
+        uint8_t from, uint8_t to)
+{
+    __m128i from_vector = _mm_set1_epi8((char)from);
+    __m128i to_vector = _mm_set1_epi8((char)to);
+    size_t cell = 0;
+    for (; cell + 16 <= count; cell += 16)
+    {
+        __m128i values = _mm_loadu_si128((const __m128i*)(cells + cell));
+        __m128i matches = _mm_cmpeq_epi8(values, from_vector);
+        values = _mm_or_si128(_mm_and_si128(matches, to_vector),
+                _mm_andnot_si128(matches, values));
+
+        _mm_storeu_si128((__m128i*)(cells + cell), values);
+    }
+
+    replace_portable(cells + cell, count - cell, from, to);
+}
+
+// Every type has a byte counter per lane that is added up (psadbw) before
+// it can overflow, after 255 vectors.
+__attribute__((target("sse2")))
+static void count_sse2(const uint8_t *types, size_t count, size_t *counts)
+{
+    size_t cell = 0;
+    while (cell + 16 <= count)
+    {
+        __m128i sums[GRID_TYPES];
+        for (size_t type = 0; type < GRID_TYPES; type++)
+        {
+            sums[type] = _mm_setzero_si128();
+        }
+
+        for (size_t block = 0; block < 255 && cell + 16 <= count;
+                block++, cell += 16)
+        {
+            __m128i values = _mm_loadu_si128((const __m128i*)(types + cell));
+            for (size_t type = 0; type < GRID_TYPES; type++)
+            {
+                sums[type] = _mm_sub_epi8(sums[type],
+                        _mm_cmpeq_epi8(values, _mm_set1_epi8((char)type)));
+            }
+        }
+
+        for (size_t type = 0; type < GRID_TYPES; type++)
+        {
+            __m128i total = _mm_sad_epu8(sums[type], _mm_setzero_si128());
+            counts[type] += _mm_cvtsi128_si32(total) +
+                _mm_cvtsi128_si32(_mm_srli_si128(total, 8));
+        }
+    }
+
+    count_portable(types + cell, count - cell, counts);
+}
+
+// Cells are selected comparing against the types of the mask, or against the
+// ones out of it when those are fewer.
+static uint16_t compared_types(uint16_t type_mask, bool *inverted)
+{
+    size_t selected_types = 0;
+    for (size_t type = 0; type < GRID_TYPES; type++)
+    {
+        selected_types += type_mask >> type & 1;
+    }
+
+    *inverted = selected_types > GRID_TYPES / 2;
+    return *inverted ? (uint16_t)~type_mask : type_mask;
+}
+
+// All ones on the bytes of values whose type is selected.
+__attribute__((target("sse2")))
+static inline __m128i select_sse2(
+        __m128i values, uint16_t compared, bool inverted)
+{
+    __m128i selected = _mm_setzero_si128();
+    for (size_t type = 0; type < GRID_TYPES; type++)
+    {
+        if (compared >> type & 1)
+        {
+            selected = _mm_or_si128(selected,
+                    _mm_cmpeq_epi8(values, _mm_set1_epi8((char)type)));
+        }
+    }
+
+    if (inverted)
+    {
+        __m128i below = _mm_min_epu8(values, _mm_set1_epi8(GRID_TYPES - 1));
+        selected = _mm_andnot_si128(selected, _mm_cmpeq_epi8(below, values));
+    }
+
+    return selected;
+}
+
+// SSE2 has neither variable shifts nor unsigned 32 bits max: the max compares
+// with the sign bit flipped.
+__attribute__((target("sse2")))
+static uint32_t max_distance_sse2(
+        const uint8_t *types, const uint32_t *distances, size_t count,
+        uint16_t type_mask)
+{
+    bool inverted;
+    uint16_t compared = compared_types(type_mask, &inverted);
+    __m128i sign = _mm_set1_epi32((int32_t)0x80000000);
+    __m128i max = _mm_setzero_si128();
+    size_t cell = 0;
+    for (; cell + 16 <= count; cell += 16)
+    {
+        __m128i values = _mm_loadu_si128((const __m128i*)(types + cell));
+        __m128i selected = select_sse2(values, compared, inverted);
+        __m128i low = _mm_unpacklo_epi8(selected, selected);
+        __m128i high = _mm_unpackhi_epi8(selected, selected);
+        __m128i lanes[4] =
+        {
+            _mm_unpacklo_epi16(low, low), _mm_unpackhi_epi16(low, low),
+            _mm_unpacklo_epi16(high, high), _mm_unpackhi_epi16(high, high)
+        };
+
+        for (size_t lane = 0; lane < 4; lane++)
+        {
+            __m128i distance = _mm_and_si128(lanes[lane], _mm_loadu_si128(
+                        (const __m128i*)(distances + cell + lane * 4)));
+
+            __m128i greater = _mm_cmpgt_epi32(_mm_xor_si128(distance, sign),
+                    _mm_xor_si128(max, sign));
+
+            max = _mm_or_si128(_mm_and_si128(greater, distance),
+                    _mm_andnot_si128(greater, max));
+        }
+    }
+
+    uint32_t lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, max);
+    uint32_t result = max_distance_portable(types + cell, distances + cell,
+            count - cell, type_mask);
+
+    for (size_t lane = 0; lane < 4; lane++)
+    {
+        result = lanes[lane] > result ? lanes[lane] : result;
+    }
+
+    return result;
+}
+
+__attribute__((target("sse2")))
+static void bits_sse2(
+        const uint8_t *types, size_t count,
+        uint16_t type_mask, uint64_t *bits)
+{
+    bool inverted;
+    uint16_t compared = compared_types(type_mask, &inverted);
+    size_t word = 0;
+    for (; word * 64 + 64 <= count; word++)
+    {
+        uint64_t value = 0;
+        for (size_t part = 0; part < 4; part++)
+        {
+            __m128i values = _mm_loadu_si128(
+                    (const __m128i*)(types + word * 64 + part * 16));
+
+            uint64_t mask = (uint16_t)_mm_movemask_epi8(
+                    select_sse2(values, compared, inverted));
+
+            value |= mask << part * 16;
+        }
+
+        bits[word] = value;
+    }
+
+    bits_portable(types + word * 64, count - word * 64, type_mask,
+            bits + word);
+}
+
+__attribute__((target("avx2")))
+static void fill_alternating_avx2(
+        uint8_t *cells, size_t count,
+        uint8_t even, uint8_t odd)
+{
+    __m256i pattern = _mm256_set1_epi16((int16_t)(even | odd << 8));
+    size_t cell = 0;
+    for (; cell + 32 <= count; cell += 32)
+    {
+        _mm256_storeu_si256((__m256i*)(cells + cell), pattern);
+    }
+
+    fill_alternating_portable(cells + cell, count - cell, even, odd);
+}
+
+__attribute__((target("avx2")))
+static void replace_avx2(
+        uint8_t *cells, size_t count,
+        uint8_t from, uint8_t to)
+{
+    __m256i from_vector = _mm256_set1_epi8((char)from);
+    __m256i to_vector = _mm256_set1_epi8((char)to);
+    size_t cell = 0;
+    for (; cell + 32 <= count; cell += 32)
+    {
+        __m256i values = _mm256_loadu_si256((const __m256i*)(cells + cell));
+        __m256i matches = _mm256_cmpeq_epi8(values, from_vector);
+        _mm256_storeu_si256((__m256i*)(cells + cell),
+                _mm256_blendv_epi8(values, to_vector, matches));
+    }
+
+    replace_portable(cells + cell, count - cell, from, to);
+}
+
+__attribute__((target("avx2")))
+static void count_avx2(const uint8_t *types, size_t count, size_t *counts)
+{
+    size_t cell = 0;
+    while (cell + 32 <= count)
+    {
+        __m256i sums[GRID_TYPES];
+        for (size_t type = 0; type < GRID_TYPES; type++)
+        {
+            sums[type] = _mm256_setzero_si256();
+        }
+
+        for (size_t block = 0; block < 255 && cell + 32 <= count;
+                block++, cell += 32)
+        {
+            __m256i values = _mm256_loadu_si256(
+                    (const __m256i*)(types + cell));
+
+            for (size_t type = 0; type < GRID_TYPES; type++)
+            {
+                sums[type] = _mm256_sub_epi8(sums[type], _mm256_cmpeq_epi8(
+                            values, _mm256_set1_epi8((char)type)));
+            }
+        }
+
+        // _mm256_extract_epi64() only exists on x86_64, the 4 sums are
+        // stored and added so 32 bit x86 builds too.
+        for (size_t type = 0; type < GRID_TYPES; type++)
+        {
+            uint64_t lanes[4];
+            _mm256_storeu_si256((__m256i*)lanes, _mm256_sad_epu8(sums[type],
+                        _mm256_setzero_si256()));
+
+            counts[type] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        }
+    }
+
+    count_portable(types + cell, count - cell, counts);
+}
+
+// Each type is widened to a lane and tested with a variable shift of the
+// mask, types from 32 on shift it out and are never selected.
+__attribute__((target("avx2")))
+static uint32_t max_distance_avx2(
+        const uint8_t *types, const uint32_t *distances, size_t count,
+        uint16_t type_mask)
+{
+    __m256i mask = _mm256_set1_epi32(type_mask);
+    __m256i max = _mm256_setzero_si256();
+    size_t cell = 0;
+    for (; cell + 8 <= count; cell += 8)
+    {
+        __m256i lane_types = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((const __m128i*)(types + cell)));
+
+        __m256i selected = _mm256_and_si256(_mm256_srlv_epi32(mask,
+                    lane_types), _mm256_set1_epi32(1));
+
+        __m256i distance = _mm256_loadu_si256(
+                (const __m256i*)(distances + cell));
+
+        max = _mm256_max_epu32(max, _mm256_and_si256(distance,
+                    _mm256_sub_epi32(_mm256_setzero_si256(), selected)));
+    }
+
+    uint32_t lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, max);
+    uint32_t result = max_distance_portable(types + cell, distances + cell,
+            count - cell, type_mask);
+
+    for (size_t lane = 0; lane < 8; lane++)
+    {
+        result = lanes[lane] > result ? lanes[lane] : result;
+    }
+
+    return result;
+}
+
+__attribute__((target("avx2")))
+static void bits_avx2(
+        const uint8_t *types, size_t count,
+        uint16_t type_mask, uint64_t *bits)
+{
+    bool inverted;
+    uint16_t compared = compared_types(type_mask, &inverted);
+    __m256i last = _mm256_set1_epi8(GRID_TYPES - 1);
+    size_t word = 0;
+    for (; word * 64 + 64 <= count; word++)
+    {
+        uint64_t value = 0;
+        for (size_t part = 0; part < 2; part++)
+        {
+            __m256i values = _mm256_loadu_si256(
+                    (const __m256i*)(types + word * 64 + part * 32));
+
+            __m256i selected = _mm256_setzero_si256();
+            for (size_t type = 0; type < GRID_TYPES; type++)
+            {
+                if (compared >> type & 1)
+                {
+                    selected = _mm256_or_si256(selected, _mm256_cmpeq_epi8(
+                                values, _mm256_set1_epi8((char)type)));
+                }
+            }
+
+            if (inverted)
+            {
+                __m256i below = _mm256_min_epu8(values, last);
+                selected = _mm256_andnot_si256(selected,
+                        _mm256_cmpeq_epi8(below, values));
+            }
+
+            uint64_t mask = (uint32_t)_mm256_movemask_epi8(selected);
+            value |= mask << part * 32;
+        }
+
+        bits[word] = value;
+    }
+
+    bits_portable(types + word * 64, count - word * 64, type_mask,
+            bits + word);
+}
+#endif
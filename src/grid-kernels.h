@@ -0,0 +1,44 @@
+#ifndef GRID_KERNELS_H
+#define GRID_KERNELS_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+
+// Types seen by grid_count(), grid_max_distance() and grid_bits(), every
+// value of enum MAZE_LEGEND is below it.
+#define GRID_TYPES 16
+
+// Bulk loops over the planes of the grid for the passes that touch every
+// cell: setting up the walls, resetting the cells marked by a generator, the
+// summary of a solved maze and the bitsets of the bitboard solver.
+// Each kernel has a portable version and, on x86, SSE2 and AVX2 ones. The
+// best the CPU supports is picked on the first call.
+enum GRID_KERNELS
+{
+    GRID_KERNELS_PORTABLE,
+    GRID_KERNELS_SSE2,
+    GRID_KERNELS_AVX2,
+    GRID_KERNELS_COUNT
+};
+
+const char * grid_kernels_name(enum GRID_KERNELS kernels);
+bool grid_kernels_supported(enum GRID_KERNELS kernels);
+bool grid_kernels_use(enum GRID_KERNELS kernels);
+
+void grid_fill(uint8_t *cells, size_t count, uint8_t value);
+void grid_fill_alternating(
+        uint8_t *cells, size_t count,
+        uint8_t even, uint8_t odd);
+
+void grid_replace(uint8_t *cells, size_t count, uint8_t from, uint8_t to);
+void grid_count(const uint8_t *types, size_t count, size_t *counts);
+uint32_t grid_max_distance(
+        const uint8_t *types, const uint32_t *distances, size_t count,
+        uint16_t type_mask);
+
+void grid_bits(
+        const uint8_t *types, size_t count,
+        uint16_t type_mask, uint64_t *bits);
+
+#endif // GRID_KERNELS_H
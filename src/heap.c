@@ -0,0 +1,101 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc, realloc, free and exit.
+#include "heap.h"
+
+static inline bool entry_less(const HeapEntry *a, const HeapEntry *b)
+{
+    return a -> cost < b -> cost ||
+        (a -> cost == b -> cost && a -> distance > b -> distance);
+}
+
+bool heap_init(NodeHeap *heap)
+{
+    heap -> capacity = 64;
+    heap -> count = 0;
+    heap -> entries = malloc(sizeof(HeapEntry) * heap -> capacity);
+    if (heap -> entries == NULL)
+    {
+        perror("Failed to allocate memory for heap\n");
+        return false;
+    }
+
+    return true;
+}
+
+void heap_push(NodeHeap *heap, Tree *node, int64_t cost)
+{
+    if (heap -> count == heap -> capacity)
+    {
+        heap -> capacity *= 2;
+        heap -> entries = realloc(heap -> entries,
+                sizeof(HeapEntry) * heap -> capacity);
+
+        if (heap -> entries == NULL)
+        {
+            perror("Failed to allocate memory for heap\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    HeapEntry entry = {cost, node -> distance_runned, node};
+    size_t child = heap -> count++;
+    while (child > 0)
+    {
+        size_t parent = (child - 1) / 2;
+        if (!entry_less(&entry, &heap -> entries[parent]))
+        {
+            break;
+        }
+
+        heap -> entries[child] = heap -> entries[parent];
+        child = parent;
+    }
+
+    heap -> entries[child] = entry;
+}
+
+// NULL once empty.
+Tree * heap_pop(NodeHeap *heap)
+{
+    if (heap -> count == 0)
+    {
+        return NULL;
+    }
+
+    Tree *top = heap -> entries[0].node;
+    HeapEntry last = heap -> entries[--heap -> count];
+    size_t parent = 0;
+    while (true)
+    {
+        size_t child = 2 * parent + 1;
+        if (child >= heap -> count)
+        {
+            break;
+        }
+
+        if (child + 1 < heap -> count &&
+                entry_less(&heap -> entries[child + 1],
+                    &heap -> entries[child]))
+        {
+            child += 1;
+        }
+
+        if (!entry_less(&heap -> entries[child], &last))
+        {
+            break;
+        }
+
+        heap -> entries[parent] = heap -> entries[child];
+        parent = child;
+    }
+
+    heap -> entries[parent] = last;
+    return top;
+}
+
+void heap_free(NodeHeap *heap)
+{
+    free(heap -> entries);
+    heap -> entries = NULL;
+    heap -> count = heap -> capacity = 0;
+}
@@ -0,0 +1,30 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include "solver.h"     // Tree.
+
+// Binary min heap of the open nodes of the best first solvers.
+// Ties on cost go to the deepest node, it's the one closer to END.
+typedef struct HeapEntry
+{
+    int64_t cost;               // Distance runned plus the heuristic.
+    int64_t distance;           // Distance runned, kept here to compare.
+    Tree *node;
+} HeapEntry;
+
+typedef struct NodeHeap
+{
+    HeapEntry *entries;
+    size_t count;
+    size_t capacity;
+} NodeHeap;
+
+bool heap_init(NodeHeap *heap);
+void heap_push(NodeHeap *heap, Tree *node, int64_t cost);
+Tree * heap_pop(NodeHeap *heap);
+void heap_free(NodeHeap *heap);
+
+#endif // HEAP_H
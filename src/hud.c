@@ -0,0 +1,139 @@
+// pthread_barrier_t (from parallel-solver.h) isn't part of c99.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>      // snprintf.
+#include <ctype.h>      // toupper.
+#include <string.h>     // strlen.
+#include "hud.h"
+
+// 3x5 font, there's no SDL_ttf. A row per byte, the left pixel is 4.
+#define HUD_GLYPH_WIDTH 3
+#define HUD_GLYPH_HEIGHT 5
+#define HUD_MARGIN 4
+#define HUD_LINES 10
+#define HUD_LINE_CHARS 32
+
+typedef struct Glyph
+{
+    char character;
+    uint8_t rows[HUD_GLYPH_HEIGHT];
+} Glyph;
+
+static const Glyph glyphs[] =
+{
+    {'0', {7, 5, 5, 5, 7}}, {'1', {2, 6, 2, 2, 7}}, {'2', {7, 1, 7, 4, 7}},
+    {'3', {7, 1, 3, 1, 7}}, {'4', {5, 5, 7, 1, 1}}, {'5', {7, 4, 7, 1, 7}},
+    {'6', {7, 4, 7, 5, 7}}, {'7', {7, 1, 1, 1, 1}}, {'8', {7, 5, 7, 5, 7}},
+    {'9', {7, 5, 7, 1, 7}}, {'A', {2, 5, 7, 5, 5}}, {'B', {6, 5, 6, 5, 6}},
+    {'C', {3, 4, 4, 4, 3}}, {'D', {6, 5, 5, 5, 6}}, {'E', {7, 4, 6, 4, 7}},
+    {'F', {7, 4, 6, 4, 4}}, {'G', {3, 4, 5, 5, 3}}, {'H', {5, 5, 7, 5, 5}},
+    {'I', {7, 2, 2, 2, 7}}, {'J', {1, 1, 1, 5, 2}}, {'K', {5, 5, 6, 5, 5}},
+    {'L', {4, 4, 4, 4, 7}}, {'M', {5, 7, 7, 5, 5}}, {'N', {6, 5, 5, 5, 5}},
+    {'O', {2, 5, 5, 5, 2}}, {'P', {6, 5, 6, 4, 4}}, {'Q', {2, 5, 5, 6, 3}},
+    {'R', {6, 5, 6, 5, 5}}, {'S', {3, 4, 2, 1, 6}}, {'T', {7, 2, 2, 2, 2}},
+    {'U', {5, 5, 5, 5, 7}}, {'V', {5, 5, 5, 5, 2}}, {'W', {5, 5, 7, 7, 5}},
+    {'X', {5, 5, 2, 5, 5}}, {'Y', {5, 5, 2, 2, 2}}, {'Z', {7, 1, 2, 4, 7}},
+    {'.', {0, 0, 0, 0, 2}}, {':', {0, 2, 0, 2, 0}}, {'/', {1, 1, 2, 4, 4}},
+    {'-', {0, 0, 7, 0, 0}},
+};
+
+static const Glyph * find_glyph(char character);
+static void draw_text(SDL_Renderer *renderer, const char *text, int x, int y);
+
+void hud_draw(SDL_Renderer *renderer, const FrameStats *stats)
+{
+    const EngineStats *engine = &stats -> engine;
+    char lines[HUD_LINES][HUD_LINE_CHARS];
+    snprintf(lines[0], HUD_LINE_CHARS, "frame    %"PRId64, stats -> frame);
+    snprintf(lines[1], HUD_LINE_CHARS, "total    %.2f ms",
+            stats -> frame_ms);
+    snprintf(lines[2], HUD_LINE_CHARS, "solve    %.2f ms", engine -> solve_ms);
+    snprintf(lines[3], HUD_LINE_CHARS, "walk     %.2f ms", engine -> walk_ms);
+    snprintf(lines[4], HUD_LINE_CHARS, "publish  %.2f ms",
+            engine -> publish_ms);
+    snprintf(lines[5], HUD_LINE_CHARS, "draw     %.2f ms", stats -> draw_ms);
+    snprintf(lines[6], HUD_LINE_CHARS, "present  %.2f ms",
+            stats -> present_ms);
+    snprintf(lines[7], HUD_LINE_CHARS, "steps    %"PRId64" / %zu heads",
+            engine -> steps, engine -> frontier);
+    snprintf(lines[8], HUD_LINE_CHARS, "nodes    %zu", engine -> nodes);
+    snprintf(lines[9], HUD_LINE_CHARS, "memory   %.1f mib",
+            engine -> bytes / (1024.0 * 1024.0));
+
+    size_t longest = 0;
+    for (int line = 0; line < HUD_LINES; line++)
+    {
+        size_t length = strlen(lines[line]);
+        longest = length > longest ? length : longest;
+    }
+
+    int advance = (HUD_GLYPH_WIDTH + 1) * HUD_SCALE;
+    int line_height = (HUD_GLYPH_HEIGHT + 2) * HUD_SCALE;
+    SDL_Rect background =
+    {
+        .x = 0,
+        .y = 0,
+        .w = longest * advance + 2 * HUD_MARGIN,
+        .h = HUD_LINES * line_height + 2 * HUD_MARGIN,
+    };
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 176);
+    SDL_RenderFillRect(renderer, &background);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    for (int line = 0; line < HUD_LINES; line++)
+    {
+        draw_text(renderer, lines[line],
+                HUD_MARGIN, HUD_MARGIN + line * line_height);
+    }
+}
+
+static const Glyph * find_glyph(char character)
+{
+    character = toupper((unsigned char)character);
+    for (size_t i = 0; i < sizeof(glyphs) / sizeof(Glyph); i++)
+    {
+        if (glyphs[i].character == character)
+        {
+            return &glyphs[i];
+        }
+    }
+
+    return NULL;
+}
+
+// A rectangle per lit pixel, sent to the renderer once per line.
+static void draw_text(SDL_Renderer *renderer, const char *text, int x, int y)
+{
+    SDL_Rect pixels[HUD_LINE_CHARS * HUD_GLYPH_WIDTH * HUD_GLYPH_HEIGHT];
+    int count = 0;
+    for (; *text != '\0'; text++, x += (HUD_GLYPH_WIDTH + 1) * HUD_SCALE)
+    {
+        const Glyph *glyph = find_glyph(*text);
+        if (glyph == NULL)
+        {
+            continue;
+        }
+
+        for (int row = 0; row < HUD_GLYPH_HEIGHT; row++)
+        {
+            for (int column = 0; column < HUD_GLYPH_WIDTH; column++)
+            {
+                if (glyph -> rows[row] & 4 >> column)
+                {
+                    pixels[count++] = (SDL_Rect)
+                    {
+                        .x = x + column * HUD_SCALE,
+                        .y = y + row * HUD_SCALE,
+                        .w = HUD_SCALE,
+                        .h = HUD_SCALE,
+                    };
+                }
+            }
+        }
+    }
+
+    SDL_RenderFillRects(renderer, pixels, count);
+}
@@ -0,0 +1,13 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include "SDL.h"        // graphics.
+#include "trace.h"      // FrameStats, where the time of a frame went.
+
+// Pixels of the window per pixel of the font.
+#define HUD_SCALE 2
+
+// Draws stats on the top left corner of the window, before presenting it.
+void hud_draw(SDL_Renderer *renderer, const FrameStats *stats);
+
+#endif // HUD_H
@@ -0,0 +1,264 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc and free.
+#include <stdint.h>     // SIZE_MAX.
+#include "junctions.h"
+
+static bool is_vertex(const Maze *maze, int32_t x, int32_t y, uint8_t moves);
+static size_t count_moves(uint8_t moves);
+static void step_cell(int32_t *x, int32_t *y, enum MAZE_MOVES move);
+
+// A pass over the grid lists the vertices and then every corridor is walked
+// once, from its end with the lowest vertex, giving the edge of both ends.
+// Nothing is kept per cell.
+bool junction_graph_build(JunctionGraph *graph, const Maze *maze)
+{
+    *graph = (JunctionGraph){0};
+    size_t capacity = 64;
+    graph -> cells = malloc(sizeof(size_t) * capacity);
+    if (graph -> cells == NULL)
+    {
+        perror("Failed to allocate memory for junction graph\n");
+        return false;
+    }
+
+    for (int32_t y = 0; y < maze -> rows; y++)
+    {
+        for (int32_t x = 0; x < maze -> columns; x++)
+        {
+            size_t cell = maze_index(maze, x, y);
+            if (maze -> types[cell] == WALL)
+            {
+                continue;
+            }
+
+            uint8_t moves = junction_moves(maze, x, y);
+            if (!is_vertex(maze, x, y, moves))
+            {
+                continue;
+            }
+
+            if (graph -> vertices == capacity)
+            {
+                capacity *= 2;
+                size_t *cells = realloc(graph -> cells,
+                        sizeof(size_t) * capacity);
+
+                if (cells == NULL)
+                {
+                    perror("Failed to allocate memory for junction graph\n");
+                    junction_graph_free(graph);
+                    return false;
+                }
+
+                graph -> cells = cells;
+            }
+
+            graph -> cells[graph -> vertices++] = cell;
+            graph -> edges_count += count_moves(moves);
+        }
+    }
+
+    // Zeroed edges (length 0) are the ones not walked yet.
+    graph -> first_edges = malloc(sizeof(size_t) * (graph -> vertices + 1));
+    graph -> edges = calloc(graph -> edges_count + 1, sizeof(JunctionEdge));
+    if (graph -> first_edges == NULL || graph -> edges == NULL)
+    {
+        perror("Failed to allocate memory for junction graph\n");
+        junction_graph_free(graph);
+        return false;
+    }
+
+    size_t edge = 0;
+    for (size_t vertex = 0; vertex < graph -> vertices; vertex++)
+    {
+        graph -> first_edges[vertex] = edge;
+        edge += count_moves(junction_moves(maze,
+                    maze_index_x(maze, graph -> cells[vertex]),
+                    maze_index_y(maze, graph -> cells[vertex])));
+    }
+
+    graph -> first_edges[graph -> vertices] = edge;
+    for (size_t vertex = 0; vertex < graph -> vertices; vertex++)
+    {
+        int32_t source_x = maze_index_x(maze, graph -> cells[vertex]);
+        int32_t source_y = maze_index_y(maze, graph -> cells[vertex]);
+        uint8_t source_moves = junction_moves(maze, source_x, source_y);
+        for (uint8_t bit = 1; bit <= 8; bit <<= 1)
+        {
+            JunctionEdge *out = &graph -> edges[graph -> first_edges[vertex] +
+                count_moves(source_moves & (bit - 1))];
+
+            if (!(source_moves & bit) || out -> length != 0)
+            {
+                continue;
+            }
+
+            int32_t x = source_x;
+            int32_t y = source_y;
+            enum MAZE_MOVES first_move = junction_bit_move(bit);
+            enum MAZE_MOVES move = first_move;
+            uint32_t length = 0;
+            uint8_t moves;
+            while (true)
+            {
+                step_cell(&x, &y, move);
+                length += 1;
+                moves = junction_moves(maze, x, y);
+                if (is_vertex(maze, x, y, moves))
+                {
+                    break;
+                }
+
+                move = junction_bit_move(moves &
+                        ~junction_move_bit(junction_opposite(move)));
+            }
+
+            size_t target = junction_graph_vertex(graph,
+                    maze_index(maze, x, y));
+
+            *out = (JunctionEdge){target, length, first_move, move};
+            enum MAZE_MOVES back = junction_opposite(move);
+            graph -> edges[graph -> first_edges[target] +
+                count_moves(moves & (junction_move_bit(back) - 1))] =
+                (JunctionEdge){vertex, length, back,
+                    junction_opposite(first_move)};
+        }
+    }
+
+    return true;
+}
+
+// Vertex on cell, SIZE_MAX if it isn't one.
+size_t junction_graph_vertex(const JunctionGraph *graph, size_t cell)
+{
+    size_t low = 0;
+    size_t high = graph -> vertices;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (graph -> cells[middle] < cell)
+        {
+            low = middle + 1;
+        }
+
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low < graph -> vertices && graph -> cells[low] == cell ?
+        low : SIZE_MAX;
+}
+
+size_t junction_graph_bytes(const JunctionGraph *graph)
+{
+    return sizeof(size_t) * (2 * graph -> vertices + 1) +
+        sizeof(JunctionEdge) * graph -> edges_count;
+}
+
+void junction_graph_free(JunctionGraph *graph)
+{
+    free(graph -> cells);
+    free(graph -> first_edges);
+    free(graph -> edges);
+    *graph = (JunctionGraph){0};
+}
+
+// Returns true if atleast one head moved.
+// Edges that end on a claimed vertex (the parent or one reached through
+// another path) are skipped before painting, so corridors are only painted
+// by the head that claims them.
+// When END is reached a node is also made on the cell before it, so the walk
+// of the winner path starts next to END as with the other solvers.
+bool junction_step(
+        const JunctionGraph *graph, Frontier *frontier,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node)
+{
+    bool atleast_one_node_moved = false;
+    for (size_t i = 0; i < frontier -> heads_count; i++)
+    {
+        Tree *node = frontier -> heads[i];
+        size_t head = maze_index(maze, node -> head_x, node -> head_y);
+        size_t vertex = junction_graph_vertex(graph, head);
+
+        paint_cell(maze, dirty, head, DEAD_HEAD, node -> distance_runned);
+        for (size_t e = graph -> first_edges[vertex];
+                e < graph -> first_edges[vertex + 1]; e++)
+        {
+            const JunctionEdge *edge = &graph -> edges[e];
+            size_t target = graph -> cells[edge -> target];
+            bool is_end = target == maze_index(maze,
+                    maze -> end_x, maze -> end_y);
+
+            if (maze -> types[target] != EMPTY && !is_end)
+            {
+                continue;
+            }
+
+            // Walks the corridor up to the cell before the target.
+            int32_t x = node -> head_x;
+            int32_t y = node -> head_y;
+            enum MAZE_MOVES move = edge -> first_move;
+            enum MAZE_MOVES entered = NONE;
+            for (uint32_t step = 1; step < edge -> length; step++)
+            {
+                step_cell(&x, &y, move);
+                paint_cell(maze, dirty, maze_index(maze, x, y), BODY,
+                        node -> distance_runned + step);
+
+                entered = move;
+                move = junction_turn(maze, x, y, move);
+            }
+
+            Tree *parent = node;
+            if (is_end && edge -> length > 1)
+            {
+                parent = add_child(node, entered, x, y,
+                        node -> distance_runned + edge -> length - 1, arena);
+            }
+
+            Tree *child = add_child(parent, edge -> last_move,
+                    maze_index_x(maze, target), maze_index_y(maze, target),
+                    node -> distance_runned + edge -> length, arena);
+
+            paint_cell(maze, dirty, head, BODY, node -> distance_runned);
+            paint_cell(maze, dirty, target, LIVE_HEAD,
+                    child -> distance_runned);
+            atleast_one_node_moved = true;
+            if (is_end && !*end_reached)
+            {
+                *end_reached = true;
+                *winner_node = parent;
+            }
+
+            else if (!is_end)
+            {
+                frontier_push(frontier, child);
+            }
+        }
+    }
+
+    frontier_swap(frontier);
+    return atleast_one_node_moved;
+}
+
+// For an open cell with moves as its open neighbours.
+static bool is_vertex(const Maze *maze, int32_t x, int32_t y, uint8_t moves)
+{
+    return count_moves(moves) != 2 ||
+        (x == maze -> start_x && y == maze -> start_y) ||
+        (x == maze -> end_x && y == maze -> end_y);
+}
+
+static size_t count_moves(uint8_t moves)
+{
+    return (moves & 1) + (moves >> 1 & 1) + (moves >> 2 & 1) + (moves >> 3);
+}
+
+static void step_cell(int32_t *x, int32_t *y, enum MAZE_MOVES move)
+{
+    *x += move == LEFT ? -1 : move == RIGHT ? 1 : 0;
+    *y += move == UP ? -1 : move == DOWN ? 1 : 0;
+}
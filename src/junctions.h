@@ -0,0 +1,92 @@
+#ifndef JUNCTIONS_H
+#define JUNCTIONS_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include "arena.h"      // Arena, bump allocator for the nodes of the tree.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // Tree, Frontier and DirtyCells.
+
+// The maze with every corridor contracted into an edge. Vertices are the open
+// cells that don't have exactly 2 open neighbours (junctions and dead ends)
+// plus START and END, an edge follows a corridor from a vertex to the next
+// one. Every corridor is an edge from each of its ends.
+// Mazes from recursive_backtracker() are mostly corridor, their graph has
+// about a tenth of the cells.
+typedef struct JunctionEdge
+{
+    size_t target;              // Vertex at the other end.
+    uint32_t length;            // Cells moved, 1 if the vertices touch.
+    uint8_t first_move;         // enum MAZE_MOVES leaving the source.
+    uint8_t last_move;          // enum MAZE_MOVES entering the target.
+} JunctionEdge;
+
+typedef struct JunctionGraph
+{
+    size_t *cells;              // maze_index() of each vertex, ascending.
+    size_t *first_edges;        // Edges of v: first_edges[v, v + 1).
+    JunctionEdge *edges;
+    size_t vertices;
+    size_t edges_count;
+} JunctionGraph;
+
+bool junction_graph_build(JunctionGraph *graph, const Maze *maze);
+size_t junction_graph_vertex(const JunctionGraph *graph, size_t cell);
+size_t junction_graph_bytes(const JunctionGraph *graph);
+void junction_graph_free(JunctionGraph *graph);
+
+// Same as forking_step() but every head moves a whole edge: the corridor is
+// painted as BODY and a node is only made on the vertex at its end.
+bool junction_step(
+        const JunctionGraph *graph, Frontier *frontier,
+        Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node);
+
+// Open neighbours of a cell as a mask, a bit per move in the order moves are
+// tried (LEFT, UP, DOWN, RIGHT) so edges keep the order of move_node().
+static inline uint8_t junction_move_bit(enum MAZE_MOVES move)
+{
+    return move == LEFT ? 1 : move == UP ? 2 : move == DOWN ? 4 :
+        move == RIGHT ? 8 : 0;
+}
+
+static inline enum MAZE_MOVES junction_bit_move(uint8_t bits)
+{
+    return bits & 1 ? LEFT : bits & 2 ? UP : bits & 4 ? DOWN :
+        bits & 8 ? RIGHT : NONE;
+}
+
+static inline enum MAZE_MOVES junction_opposite(enum MAZE_MOVES move)
+{
+    return move == LEFT ? RIGHT : move == RIGHT ? LEFT :
+        move == UP ? DOWN : move == DOWN ? UP : NONE;
+}
+
+static inline uint8_t junction_moves(const Maze *maze, int32_t x, int32_t y)
+{
+    const uint8_t *types = maze -> types;
+    size_t cell = maze_index(maze, x, y);
+    size_t columns = maze -> columns;
+    return (x > 0 && types[cell - 1] != WALL) |
+        (y > 0 && types[cell - columns] != WALL) << 1 |
+        (y < maze -> rows - 1 && types[cell + columns] != WALL) << 2 |
+        (x < maze -> columns - 1 && types[cell + 1] != WALL) << 3;
+}
+
+// Move that leaves a cell entered through move: straight ahead if it's open,
+// otherwise the first open side. On a corridor that's the only way on.
+static inline enum MAZE_MOVES junction_turn(
+        const Maze *maze, int32_t x, int32_t y, enum MAZE_MOVES move)
+{
+    uint8_t moves = junction_moves(maze, x, y);
+    if (moves & junction_move_bit(move))
+    {
+        return move;
+    }
+
+    return junction_bit_move(moves &
+            ~junction_move_bit(junction_opposite(move)));
+}
+
+#endif // JUNCTIONS_H
@@ -0,0 +1,235 @@
+// mmap, madvise and open aren't part of c99.
+#define _DEFAULT_SOURCE
+
+#include <stdlib.h>     // malloc and free.
+#include <string.h>     // memset, memcpy and memcmp.
+#include <fcntl.h>      // open.
+#include <unistd.h>     // close.
+#include <sys/stat.h>   // fstat.
+#include <sys/mman.h>   // mmap, madvise and munmap.
+#include "maze-file.h"
+
+static bool valid_header(const MazeFileHeader *header);
+
+// Start is top left corner and end is bottom right corner, as generated.
+void maze_file_header(
+        MazeFileHeader *header,
+        int32_t rows, int32_t columns,
+        uint32_t generator, uint64_t seed)
+{
+    memset(header, 0, sizeof(MazeFileHeader));
+    memcpy(header -> magic, MAZE_FILE_MAGIC, sizeof(MAZE_FILE_MAGIC));
+    header -> version = MAZE_FILE_VERSION;
+    header -> generator = generator;
+    header -> seed = seed;
+    header -> rows = rows;
+    header -> columns = columns;
+    header -> start_x = 0;
+    header -> start_y = 0;
+    header -> end_x = columns - 1;
+    header -> end_y = rows - 1;
+}
+
+bool maze_file_write_header(FILE *file, const MazeFileHeader *header)
+{
+    if (fwrite(header, sizeof(MazeFileHeader), 1, file) != 1)
+    {
+        perror("Failed to write maze file header\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool maze_file_read_header(const char *path, MazeFileHeader *header)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        perror("Failed to open maze file\n");
+        return false;
+    }
+
+    bool read = fread(header, sizeof(MazeFileHeader), 1, file) == 1;
+    fclose(file);
+    if (!read || !valid_header(header))
+    {
+        fprintf(stderr, "%s is not a maze file of version %d\n",
+                path, MAZE_FILE_VERSION);
+        return false;
+    }
+
+    return true;
+}
+
+// Walls of the carved cells of maze, the borders count as walls.
+bool maze_file_save(
+        const char *path, const Maze *maze,
+        uint32_t generator, uint64_t seed)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        perror("Failed to create maze file\n");
+        return false;
+    }
+
+    MazeFileHeader header;
+    maze_file_header(&header, maze -> rows, maze -> columns, generator, seed);
+    header.start_x = maze -> start_x;
+    header.start_y = maze -> start_y;
+    header.end_x = maze -> end_x;
+    header.end_y = maze -> end_y;
+
+    size_t row_bytes = maze_file_row_bytes(maze -> columns);
+    uint8_t *row = malloc(row_bytes);
+    if (row == NULL)
+    {
+        perror("Failed to allocate memory for maze file row\n");
+        fclose(file);
+        return false;
+    }
+
+    bool written = maze_file_write_header(file, &header);
+    for (int32_t y = 0; y < maze -> rows && written; y += 2)
+    {
+        memset(row, 0, row_bytes);
+        size_t cell = maze_index(maze, 0, y);
+        for (int32_t x = 0; x < maze -> columns; x += 2, cell += 2)
+        {
+            bool right = x + 1 >= maze -> columns ||
+                maze -> types[cell + 1] == WALL;
+            bool down = y + 1 >= maze -> rows ||
+                maze -> types[cell + maze -> columns] == WALL;
+
+            maze_file_set_walls(row, x / 2,
+                    (right ? MAZE_FILE_WALL_RIGHT : 0) |
+                    (down ? MAZE_FILE_WALL_DOWN : 0));
+        }
+
+        written = fwrite(row, row_bytes, 1, file) == 1;
+    }
+
+    if (!written)
+    {
+        perror("Failed to write maze file\n");
+    }
+
+    free(row);
+    return fclose(file) == 0 && written;
+}
+
+// The file is mapped and decoded straight from the page cache into a grid,
+// which lives on grid_path instead of memory if it isn't NULL.
+// The header is copied to header if it isn't NULL.
+Maze * maze_file_load(
+        const char *path, const char *grid_path,
+        MazeFileHeader *header)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        perror("Failed to open maze file\n");
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return NULL;
+    }
+
+    size_t file_bytes = info.st_size;
+    const uint8_t *mapped = file_bytes < sizeof(MazeFileHeader) ? NULL :
+        mmap(NULL, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+    if (mapped == NULL || mapped == MAP_FAILED)
+    {
+        fprintf(stderr, "%s is not a maze file of version %d\n",
+                path, MAZE_FILE_VERSION);
+        return NULL;
+    }
+
+    MazeFileHeader file_header;
+    memcpy(&file_header, mapped, sizeof(MazeFileHeader));
+    size_t row_bytes = maze_file_row_bytes(file_header.columns);
+    if (!valid_header(&file_header) || file_bytes != sizeof(MazeFileHeader) +
+            (size_t)(file_header.rows / 2 + 1) * row_bytes)
+    {
+        fprintf(stderr, "%s is not a maze file of version %d\n",
+                path, MAZE_FILE_VERSION);
+        munmap((void*)mapped, file_bytes);
+        return NULL;
+    }
+
+    // Read once from start to end.
+    madvise((void*)mapped, file_bytes, MADV_SEQUENTIAL);
+
+    Maze *maze = grid_path == NULL ?
+        maze_create(file_header.rows, file_header.columns) :
+        maze_create_mapped(file_header.rows, file_header.columns, grid_path);
+
+    if (maze == NULL)
+    {
+        munmap((void*)mapped, file_bytes);
+        return NULL;
+    }
+
+    const uint8_t *row = mapped + sizeof(MazeFileHeader);
+    for (int32_t y = 0; y < maze -> rows; y += 2, row += row_bytes)
+    {
+        size_t cell = maze_index(maze, 0, y);
+        for (int32_t x = 0; x < maze -> columns; x += 2, cell += 2)
+        {
+            uint8_t walls = maze_file_walls(row, x / 2);
+            maze -> types[cell] = EMPTY;
+            if (x + 1 < maze -> columns)
+            {
+                maze -> types[cell + 1] =
+                    walls & MAZE_FILE_WALL_RIGHT ? WALL : EMPTY;
+            }
+
+            if (y + 1 < maze -> rows)
+            {
+                maze -> types[cell + maze -> columns] =
+                    walls & MAZE_FILE_WALL_DOWN ? WALL : EMPTY;
+            }
+
+            if (x + 1 < maze -> columns && y + 1 < maze -> rows)
+            {
+                maze -> types[cell + maze -> columns + 1] = WALL;
+            }
+        }
+    }
+
+    munmap((void*)mapped, file_bytes);
+
+    maze -> start_x = file_header.start_x;
+    maze -> start_y = file_header.start_y;
+    maze -> end_x = file_header.end_x;
+    maze -> end_y = file_header.end_y;
+    maze -> types[maze_index(maze, maze -> start_x, maze -> start_y)] = START;
+    maze -> types[maze_index(maze, maze -> end_x, maze -> end_y)] = END;
+    if (header != NULL)
+    {
+        *header = file_header;
+    }
+
+    return maze;
+}
+
+// Start and end must be carved cells inside the grid.
+static bool valid_header(const MazeFileHeader *header)
+{
+    return memcmp(header -> magic, MAZE_FILE_MAGIC,
+                sizeof(MAZE_FILE_MAGIC)) == 0 &&
+           header -> version == MAZE_FILE_VERSION &&
+           header -> rows > 0 && header -> rows % 2 == 1 &&
+           header -> columns > 0 && header -> columns % 2 == 1 &&
+           header -> start_x >= 0 && header -> start_x < header -> columns &&
+           header -> start_y >= 0 && header -> start_y < header -> rows &&
+           header -> end_x >= 0 && header -> end_x < header -> columns &&
+           header -> end_y >= 0 && header -> end_y < header -> rows &&
+           header -> start_x % 2 == 0 && header -> start_y % 2 == 0 &&
+           header -> end_x % 2 == 0 && header -> end_y % 2 == 0;
+}
@@ -0,0 +1,66 @@
+#ifndef MAZE_FILE_H
+#define MAZE_FILE_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include <stdio.h>      // FILE.
+#include "maze.h"       // Maze, flat grid and its index API.
+
+// A maze file is a header followed by the walls of the carved cells (even
+// coordinates), row by row, 2 bits per cell: a wall on the right and a wall
+// below. Every packed row starts on a byte so rows can be written as they are
+// generated. Numbers are stored in the machine byte order.
+// The header keeps the generator and seed that made the maze so a run can be
+// traced back, a version bump is needed for any change to the layout.
+#define MAZE_FILE_MAGIC "MAZEVIS"
+#define MAZE_FILE_VERSION 1
+
+#define MAZE_FILE_WALL_RIGHT 1
+#define MAZE_FILE_WALL_DOWN 2
+
+typedef struct MazeFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t generator;         // enum GENERATORS that made it.
+    uint64_t seed;
+    int32_t rows;               // Of the grid, both odd.
+    int32_t columns;
+    int32_t start_x, start_y;
+    int32_t end_x, end_y;
+} MazeFileHeader;
+
+void maze_file_header(
+        MazeFileHeader *header,
+        int32_t rows, int32_t columns,
+        uint32_t generator, uint64_t seed);
+
+bool maze_file_write_header(FILE *file, const MazeFileHeader *header);
+bool maze_file_read_header(const char *path, MazeFileHeader *header);
+bool maze_file_save(
+        const char *path, const Maze *maze,
+        uint32_t generator, uint64_t seed);
+
+Maze * maze_file_load(
+        const char *path, const char *grid_path,
+        MazeFileHeader *header);
+
+// Bytes of a packed row of walls for a grid with columns columns.
+static inline size_t maze_file_row_bytes(int32_t columns)
+{
+    return ((size_t)(columns / 2 + 1) * 2 + 7) / 8;
+}
+
+static inline void maze_file_set_walls(
+        uint8_t *row, size_t column, uint8_t walls)
+{
+    row[column / 4] |= walls << (column % 4 * 2);
+}
+
+static inline uint8_t maze_file_walls(const uint8_t *row, size_t column)
+{
+    return row[column / 4] >> (column % 4 * 2) & 3;
+}
+
+#endif // MAZE_FILE_H
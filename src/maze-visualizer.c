@@ -1,14 +1,33 @@
 // TODO: Have better documentation.
 //       current documentation is not great.
 
+// clock_gettime() and CLOCK_MONOTONIC aren't part of c99.
+#define _POSIX_C_SOURCE 200809L
+
 // Libraries needed, here's a quick summary:
 #include <stdbool.h>    // bool, true and false macros.
-#include <stdlib.h>     // malloc, free, rand and srand.
+#include <stdlib.h>     // malloc, free and strtoull.
+#include <string.h>     // strcmp.
 #include <inttypes.h>   // intN_t and uintN_t.
+#include <stdint.h>     // INT32_MAX.
 #include <errno.h>      // global error variable "errno" and error macros.
-#include <time.h>       // time(NULL) as a seed for generating "randomness".
+#include <time.h>       // time(NULL) as the default seed.
 #include <argp.h>       // parsing of arguments on command line.
 #include "SDL.h"        // graphics.
+#include "arena.h"      // Arena, bump allocator for the nodes of the tree.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // Tree, Frontier and tree forking solver.
+#include "solvers.h"    // Solver strategies and find_path_headless().
+#include "engine.h"     // Solver thread that publishes grid snapshots.
+#include "generator.h"  // Maze generators.
+#include "maze-file.h"  // Packed maze files.
+#include "rng.h"        // Rng, seedable random numbers.
+#include "render.h"     // Display, drawing of the maze.
+#include "trace.h"      // FrameStats and the CSV writer thread.
+#include "export.h"     // Exporter, the PNG and Y4M writer thread.
+#include "batch.h"      // Many seeded mazes solved on a pool of threads.
+#include "hud.h"        // Stats drawn over the maze.
+#include "platform.h"   // get_time_ms() and available_memory().
 
 // Concatenate string with number, e.g "Pi is: " STR(3.14159)
 // on preprocessing.
@@ -24,12 +43,27 @@
 #define DEFAULT_MAZE_COLUMNS 63
 #define DEFAULT_SHOW_BODY true
 #define DEFAULT_SHOW_DEAD_HEAD true
+#define DEFAULT_HEADLESS false
+#define DEFAULT_RENDERER RENDERER_TEXTURE
+#define DEFAULT_RENDERER_NAME texture
+#define DEFAULT_GRADIENT GRADIENT_GREEN
+#define DEFAULT_GRADIENT_NAME green
+#define DEFAULT_THREADS 1
+#define DEFAULT_STEPS_PER_FRAME 1
+#define DEFAULT_GENERATOR GENERATOR_BACKTRACKER
+#define DEFAULT_GENERATOR_NAME backtracker
+#define DEFAULT_VERIFY false
+#define DEFAULT_SOLVER SOLVER_FORKING
+#define DEFAULT_SOLVER_NAME forking
+#define DEFAULT_BATCH 0
+#define DEFAULT_JOBS 0          // One per core.
 // End of default values for options
 
 // SDL poll events
 #define USER_QUIT_EVENT 0
 #define USER_PAUSE_EVENT 1
 #define USER_UNKNOWN_EVENT 2
+#define USER_HUD_EVENT 3
 // End of SDL poll events
 
 // Enum declaration
@@ -41,64 +75,55 @@ enum SHORT_OPTION_KEYCODES
     OPTION_SHOW_BODY,
     OPTION_SHOW_FULLSCREEN,
     OPTION_SHOW_DEAD_HEAD,
+    OPTION_HEADLESS,
+    OPTION_RENDERER,
+    OPTION_GRADIENT,
+    OPTION_THREADS,
+    OPTION_STEPS_PER_FRAME,
+    OPTION_GENERATOR,
+    OPTION_VERIFY,
+    OPTION_STREAM_MAZE,
+    OPTION_LOAD_MAZE,
+    OPTION_GRID_FILE,
+    OPTION_SAVE_MAZE,
+    OPTION_SEED,
+    OPTION_TRACE,
+    OPTION_SOLVER,
+    OPTION_EXPORT,
+    OPTION_BATCH,
+    OPTION_JOBS,
 };
 
-enum MAZE_LEGEND
-{
-    EMPTY,
-    WALL,
-    BODY,
-    DEAD_HEAD,
-    LIVE_HEAD,
-    START,
-    END,
-    WIN_BLOCK,
-    VISITED     // Visited is only used on generating the maze
-                // recursive_backtracker()
-};
-
-enum MAZE_MOVES {NONE, LEFT, RIGHT, DOWN, UP};
-enum MOVE_STATES {NODE_END_REACHED, NODE_MOVED, NODE_CANT_MOVE};
 
 // Typedef struct declaration
-typedef struct Cell
-{
-    enum MAZE_LEGEND type;
-    int32_t distance_runned;
-} Cell;
-
-typedef struct Maze
-{
-    Cell **matrix;
-    int16_t rows;
-    int16_t columns;
-    int16_t start_x, start_y;
-    int16_t end_x, end_y;
-
-} Maze;
-
-typedef struct Tree
-{
-    int16_t parent_move;        /* Parent move that got u here */
-    int16_t head_x;
-    int16_t head_y;
-    struct Tree *parent;
-    int16_t parent_index;       // Idx of tree on the parent children array
-    int16_t children_count;     /* On a maze it would be 4 available moves */
-    int32_t distance_runned;
-    struct Tree **children;
-} Tree;
-
 typedef struct Arguments
 {
     int16_t fps;
     int screen_width;
     int screen_height;
-    uint16_t maze_rows;
-    uint16_t maze_columns;
+    int32_t maze_rows;
+    int32_t maze_columns;
     bool fullscreen;
     bool show_body;
     bool show_dead_head;
+    bool headless;
+    enum RENDERERS renderer;
+    enum GRADIENTS gradient;
+    int32_t threads;
+    int32_t steps_per_frame;
+    enum GENERATORS generator;
+    bool verify;
+    const char *stream_maze;
+    const char *load_maze;
+    const char *save_maze;
+    uint64_t seed;
+    bool has_seed;              // Otherwise the seed is time(NULL).
+    const char *grid_file;
+    const char *trace;
+    enum SOLVERS solver;
+    const char *export;
+    int32_t batch;
+    int32_t jobs;
 } Arguments;
 
 // Global variables used by argp.h
@@ -155,44 +180,117 @@ static struct argp_option options[] =
         "show head that can't move: " STR(DEFAULT_SHOW_DEAD_HEAD)
             " by default.", 5},
 
+    {"headless", OPTION_HEADLESS, 0, 0,
+        "generate and solve without window nor frame pacing, then print "
+        "the summary with timings.", 6},
+
+    {"renderer", OPTION_RENDERER, "NAME", 0,
+        "texture (one texel per cell, scaled on a single copy) or rects "
+        "(one rectangle per cell): " STR(DEFAULT_RENDERER_NAME)
+            " by default.", 7},
+
+    {"gradient", OPTION_GRADIENT, "NAME", 0,
+        "body colors by distance runned: green (saturation ramp), rainbow "
+        "(hues spread over the maze) or cycle (hues repeat every "
+        STR(GRADIENT_CYCLE_LENGTH) " cells, for very long solves): "
+        STR(DEFAULT_GRADIENT_NAME) " by default.", 8},
+
+    {"threads", OPTION_THREADS, "NUM", 0,
+        "threads that move the heads of each generation, same result as "
+        "with one: " STR(DEFAULT_THREADS) " by default.", 9},
+
+    {"steps_per_frame", OPTION_STEPS_PER_FRAME, "NUM", 0,
+        "solver steps (generations or winner path cells) per frame, the "
+        "solver runs on its own thread and 0 lets it run as fast as "
+        "possible: " STR(DEFAULT_STEPS_PER_FRAME) " by default.", 10},
+
+    {"generator", OPTION_GENERATOR, "NAME", 0,
+        "backtracker (long winding corridors), kruskal (many short dead "
+        "ends), wilson (uniform spanning tree) or eller (row by row): "
+        STR(DEFAULT_GENERATOR_NAME) " by default.", 11},
+
+    {"verify", OPTION_VERIFY, 0, 0,
+        "check that the generated maze is perfect (one path between any two "
+        "cells) before solving it.", 12},
+
+    {"stream_maze", OPTION_STREAM_MAZE, "FILE", 0,
+        "generate with eller writing each row to FILE as packed walls, only "
+        "a row is kept in memory so the maze can be bigger than it, then "
+        "exit without solving.", 13},
+
+    {"load_maze", OPTION_LOAD_MAZE, "FILE", 0,
+        "solve the maze of FILE instead of generating one, rows and columns "
+        "are the ones of the file.", 14},
+
+    {"grid_file", OPTION_GRID_FILE, "FILE", 0,
+        "keep the grid of the loaded maze on FILE (mapped, paged by the "
+        "system) instead of memory, only with --load_maze.", 15},
+
+    {"save_maze", OPTION_SAVE_MAZE, "FILE", 0,
+        "write the maze to FILE (2 bits per cell, generator and seed on the "
+        "header) before solving it, --load_maze replays it.", 16},
+
+    {"seed", OPTION_SEED, "NUM", 0,
+        "seed of the random numbers (64 bits), the same seed and options "
+        "give the same maze: time of the run by default.", 17},
+
+    {"trace", OPTION_TRACE, "FILE", 0,
+        "write the time of each stage of every frame, the live heads, nodes "
+        "and bytes of the tree to FILE as CSV, from its own thread.", 18},
+
+    {"solver", OPTION_SOLVER, "NAME", 0,
+        "forking (a tree from start), bidirectional (trees from start "
+        "and end until they touch), astar (best first by distance to end), "
+        "jps (astar jumping over straight runs), junctions (forking over "
+        "corridors contracted into edges), compact (forking with 2 bits "
+        "per cell instead of a tree, for huge mazes) or bitboard (forking "
+        "on bitsets, 64 cells at once), all but forking are single "
+        "threaded: " STR(DEFAULT_SOLVER_NAME) " by default.", 19},
+
+    {"export", OPTION_EXPORT, "DIR|FILE" EXPORT_Y4M_EXTENSION, 0,
+        "draw a frame every steps_per_frame steps (0 only draws the first "
+        "and the last) off screen, screen_width x screen_height, and write "
+        "them from their own thread as a Y4M video at fps if the name ends "
+        "in " EXPORT_Y4M_EXTENSION " or as PNG files on DIR otherwise. No "
+        "window is opened.", 20},
+
+    {"batch", OPTION_BATCH, "NUM", 0,
+        "generate and solve NUM mazes headless, each from its own stream of "
+        "the seed, then print the min, mean, percentiles and max of the "
+        "nodes, heads, distance, generations and times.", 21},
+
+    {"jobs", OPTION_JOBS, "NUM", 0,
+        "threads that take the mazes of --batch, each reusing its grid and "
+        "tree arena: one per core by default.", 22},
+
     {0}
 };
 
 // Prototypes
 // Tree related
-Tree * create_node(void);
 bool find_path(
-        SDL_Window *window, SDL_Renderer *renderer,
-        Tree *root, Maze *maze,
+        Display *display,
+        Tree *root, Arena *arena, Maze *maze,
         const Arguments *args);
 
-enum MOVE_STATES move_node(Tree *node, Maze *maze);
-Tree * find_left_leaf(Tree * node);
-Tree * find_next_leaf(Tree *node);
-void nodes_info(
-        const Maze *maze,
-        int32_t *total, int32_t *live, int32_t *dead,
-        int32_t *distance_runned);
-
+bool export_path(
+        Tree *root, Arena *arena, Maze *maze,
+        const Arguments *args,
+        bool *found, int64_t *generations, int64_t *frames);
 
-// Graphics
-void hsl_to_rgb(
-        double hue, double saturation, double lightness,
-        int *r, int *g, int *b);
+bool export_draw(
+        Display *display, const Maze *maze, DirtyCells *dirty,
+        Exporter *exporter);
 
-void draw_maze(
-        SDL_Window *window,
-        SDL_Renderer *renderer,
-        const Maze *maze,
-        const Arguments *args);
 
 // Maze generation
-int SO_random(int min, int max);
-Maze * recursive_backtracker(int16_t rows, int16_t columns);
+Maze * create_maze(const Arguments *args, Rng *rng);
+double estimate_memory(const Arguments *args);
+bool verify_maze(const Maze *maze);
 
 // Getting user input from terminal and keyboard.
 static error_t parse_opt(int32_t key, char *arg, struct argp_state *state);
-uint8_t get_key(void);
+uint8_t get_key(bool *window_changed, Viewport *view);
 
 /////////////////
 // Entry point //
@@ -221,15 +319,196 @@ int32_t main(int32_t argc, char *argv[])
         .maze_columns = DEFAULT_MAZE_COLUMNS,
         .show_body = DEFAULT_SHOW_BODY,
         .show_dead_head = DEFAULT_SHOW_DEAD_HEAD,
+        .headless = DEFAULT_HEADLESS,
+        .renderer = DEFAULT_RENDERER,
+        .gradient = DEFAULT_GRADIENT,
+        .threads = DEFAULT_THREADS,
+        .steps_per_frame = DEFAULT_STEPS_PER_FRAME,
+        .generator = DEFAULT_GENERATOR,
+        .verify = DEFAULT_VERIFY,
+        .stream_maze = NULL,
+        .load_maze = NULL,
+        .save_maze = NULL,
+        .seed = 0,
+        .has_seed = false,
+        .grid_file = NULL,
+        .trace = NULL,
+        .solver = DEFAULT_SOLVER,
+        .export = NULL,
+        .batch = DEFAULT_BATCH,
+        .jobs = DEFAULT_JOBS,
     };
 
     // Succesfull parsing
     if (argp_parse(&argp, argc, argv, ARGP_NO_HELP, 0, &args) == 0)
     {
-        long seed = time(NULL);
-        printf("Seed: %lu\n", seed);
-        srand(seed);
+        if (!args.has_seed)
+        {
+            args.seed = time(NULL);
+        }
+
+        // A loaded maze prints the seed it was made from instead.
+        if (args.load_maze == NULL)
+        {
+            printf("Seed: %"PRIu64"\n", args.seed);
+        }
+
+        Rng rng;
+        rng_seed(&rng, args.seed);
+
+        // Rows go to the file as they are carved, there's nothing to solve.
+        if (args.stream_maze != NULL)
+        {
+            double generation_start = get_time_ms();
+            bool written = eller_stream(args.stream_maze,
+                    args.maze_rows, args.maze_columns, &rng, args.seed);
+            printf("Maze time:   %.3f ms\n",
+                    get_time_ms() - generation_start);
+            return written ? EXIT_SUCCESS : 1;
+        }
+
+        if (args.grid_file != NULL && args.load_maze == NULL)
+        {
+            fprintf(stderr, "--grid_file needs --load_maze\n");
+            return 1;
+        }
+
+        if (args.batch > 0 && (args.load_maze != NULL ||
+                    args.save_maze != NULL || args.export != NULL))
+        {
+            fprintf(stderr, "--batch generates its own mazes, it can't be "
+                    "used with --load_maze, --save_maze nor --export\n");
+            return 1;
+        }
+
+        // Every job holds a maze and its solver at once.
+        int32_t jobs = args.jobs == 0 ? available_cores() : args.jobs;
+        jobs = args.batch > 0 && jobs > args.batch ? args.batch : jobs;
+
+        // The maze file knows its dimensions.
+        if (args.load_maze != NULL)
+        {
+            MazeFileHeader header;
+            if (!maze_file_read_header(args.load_maze, &header))
+            {
+                return 1;
+            }
+
+            args.maze_rows = header.rows;
+            args.maze_columns = header.columns;
+        }
+
+        // Better to refuse now than to run out of memory mid solve. Each job
+        // of a batch keeps a maze, a tree and its results for every maze.
+        double memory_needed = args.batch > 0 ?
+            estimate_memory(&args) * jobs + batch_memory(args.batch) :
+            estimate_memory(&args);
+        double memory_available = available_memory();
+        printf("Memory estimate: %.1f MiB\n", memory_needed / (1 << 20));
+        if (memory_available > 0 && memory_needed > memory_available)
+        {
+            fprintf(stderr, "Not enough memory: %.1f MiB needed but only "
+                    "%.1f MiB available\n",
+                    memory_needed / (1 << 20), memory_available / (1 << 20));
+            return 1;
+        }
+
+        if (args.batch > 0)
+        {
+            Batch batch =
+            {
+                .generator = args.generator,
+                .rows = args.maze_rows,
+                .columns = args.maze_columns,
+                .solver = args.solver,
+                .threads = args.threads,
+                .count = args.batch,
+                .jobs = jobs,
+            };
+
+            bool solved = batch_run(&batch, args.seed);
+            if (solved)
+            {
+                batch_report(&batch);
+            }
+
+            batch_free(&batch);
+            return solved ? EXIT_SUCCESS : 1;
+        }
+
+        // No window, no frame pacing: generate, solve and report. Exports
+        // draw their frames off screen, so they don't need a window either.
+        if (args.headless || args.export != NULL)
+        {
+            Arena tree_arena;
+            if (!arena_init(&tree_arena,
+                        sizeof(Tree) * TREE_ARENA_BLOCK_NODES))
+            {
+                return 1;
+            }
 
+            Tree * root = create_node(&tree_arena);
+            if (root == NULL)
+            {
+                perror("Couldn't crate initial root\n");
+                return 1;
+            }
+
+            double generation_start = get_time_ms();
+            Maze *maze = create_maze(&args, &rng);
+            double generation_time = get_time_ms() - generation_start;
+            if (maze == NULL)
+            {
+                return 1;
+            }
+
+            root -> head_x = maze -> start_x;
+            root -> head_y = maze -> start_y;
+
+            int64_t generations = 0;
+            int64_t frames = 0;
+            bool result = false;
+            double solve_start = get_time_ms();
+            if (args.export == NULL)
+            {
+                result = find_path_headless(args.solver,
+                        root, &tree_arena, maze, args.threads, &generations);
+            }
+
+            else if (!export_path(root, &tree_arena, maze, &args,
+                        &result, &generations, &frames))
+            {
+                arena_free(&tree_arena);
+                maze_free(maze);
+                return 1;
+            }
+
+            double solve_time = get_time_ms() - solve_start;
+
+            int64_t total, live_head, dead_head, distance_runned;
+            total = live_head = dead_head = distance_runned = 0;
+            nodes_info(maze, &total, &live_head, &dead_head,
+                    &distance_runned);
+            printf("%s\n", result ? "FOUND" : "NO FOUND");
+            printf("Total nodes: %"PRId64"\n"
+                "Live head:   %"PRId64"\n"
+                "Dead head:   %"PRId64"\n"
+                "Distance:    %"PRId64"\n"
+                "Generations: %"PRId64"\n"
+                "Maze time:   %.3f ms\n"
+                "Solve time:  %.3f ms\n",
+                total, live_head, dead_head, distance_runned, generations,
+                generation_time, solve_time);
+
+            if (args.export != NULL)
+            {
+                printf("Frames:      %"PRId64"\n", frames);
+            }
+
+            arena_free(&tree_arena);
+            maze_free(maze);
+            return EXIT_SUCCESS;
+        }
 
         // Unsuccessfull creation of video.
         if (SDL_Init(SDL_INIT_VIDEO) < 0)
@@ -253,29 +532,74 @@ int32_t main(int32_t argc, char *argv[])
             return 1;
         }
 
-        Tree * root = create_node();
+        Arena tree_arena;
+        if (!arena_init(&tree_arena, sizeof(Tree) * TREE_ARENA_BLOCK_NODES))
+        {
+            return 1;
+        }
+
+        Tree * root = create_node(&tree_arena);
         if (root == NULL)
         {
             perror("Couldn't crate initial root\n");
             return 1;
         }
         
-        Maze *maze = recursive_backtracker(args.maze_rows, args.maze_columns);
+        Maze *maze = create_maze(&args, &rng);
+        if (maze == NULL)
+        {
+            return 1;
+        }
+
         root -> head_x = maze -> start_x;
         root -> head_y = maze -> start_y;
 
-        bool result = find_path(window, renderer, root, maze, &args);
-        int32_t total, live_head, dead_head, distance_runned;
+        Display display =
+        {
+            .window = window,
+            .renderer = renderer,
+            .texture = NULL,
+            .pixels = NULL,
+            .show_body = args.show_body,
+            .show_dead_head = args.show_dead_head,
+        };
+
+        if (args.renderer == RENDERER_TEXTURE &&
+                !create_texture(&display, maze))
+        {
+            SDL_Log("Drawing the maze from the mipmap only");
+        }
+
+        // Zoomed out views, and mazes too big for a texture, are drawn from
+        // the mipmap.
+        if (args.renderer == RENDERER_TEXTURE &&
+                !mipmap_init(&display.mipmap, maze))
+        {
+            SDL_Log("Zooming out under a pixel per cell is disabled");
+        }
+
+        if (!gradient_init(&display.gradient, args.gradient, maze))
+        {
+            return 1;
+        }
+
+        bool result = find_path(
+                &display, root, &tree_arena, maze, &args);
+        int64_t total, live_head, dead_head, distance_runned;
         total = live_head = dead_head = distance_runned = 0;
         nodes_info(maze, &total, &live_head, &dead_head, &distance_runned);
         printf("%s\n", result ? "FOUND" : "NO FOUND");
-        printf("Total nodes: %d\n"
-            "Live head:   %d\n"
-            "Dead head:   %d\n"
-            "Distance:    %d\n",
+        printf("Total nodes: %"PRId64"\n"
+            "Live head:   %"PRId64"\n"
+            "Dead head:   %"PRId64"\n"
+            "Distance:    %"PRId64"\n",
             total, live_head, dead_head, distance_runned);
 
-        
+        // The whole tree goes away at once.
+        arena_free(&tree_arena);
+        maze_free(maze);
+        display_free(&display);
+        gradient_free(&display.gradient);
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         SDL_Quit();
@@ -283,99 +607,9 @@ int32_t main(int32_t argc, char *argv[])
     }
 }
 
-Tree * create_node(void)
-{
-    Tree * node = malloc(sizeof(Tree));
-    if (node == NULL)
-    {
-        perror("Failed to allocate memory for node\n");
-        return NULL;
-    }
-
-    node -> parent = NULL;
-    node -> children_count = 0;
-    node -> children = NULL;
-    node -> head_x = -1;
-    node -> head_y = -1;
-    node -> parent_index = -1;
-    node -> parent_move = NONE;
-    node -> distance_runned = 0;
-    return node;
-}
-
-enum MOVE_STATES move_node(Tree *node, Maze *maze)
-{
-
-    enum MAZE_MOVES moves[] = {LEFT, UP, DOWN, RIGHT};
-    size_t move_quantity = sizeof(moves) / sizeof(enum MAZE_MOVES);
-    int16_t tx, ty;
-
-    bool end_reached = false;
-    maze -> matrix[node -> head_y][node -> head_x].type = DEAD_HEAD;
-
-    for (size_t move = 0; move < move_quantity; move++)
-    {
-        // Checking for out of bounds
-        if ((moves[move] == LEFT && node -> head_x <= 0) ||
-            (moves[move] == RIGHT &&
-                node -> head_x >= maze -> columns - 1) ||
-            (moves[move] == UP && node -> head_y <= 0) ||
-            (moves[move] == DOWN && node -> head_y >= maze -> rows - 1))
-        {
-            continue;
-        }
-
-        tx = node -> head_x + (moves[move] == LEFT ? -1 :
-                                moves[move] == RIGHT ? 1 : 0);
-        ty = node -> head_y + (moves[move] == UP ? -1 :
-                                moves[move] == DOWN ? 1 : 0);
-
-        // Can't move to a WALL or
-        // A part where already moved to avoid infinite recursion.
-        if (maze -> matrix[ty][tx].type != EMPTY &&
-            !(ty == maze -> end_y && tx == maze -> end_x))
-        {
-            continue;
-        }
-
-        // Succesfull move
-        // Initializing a new node
-        node -> children_count += 1;
-        node -> children = realloc(node -> children,
-                node -> children_count * sizeof(Tree **));
-        
-        node -> children[node -> children_count - 1] = create_node();
-        node -> children[node -> children_count - 1] -> parent_move = 
-            moves[move];
-
-        node -> children[node -> children_count - 1] -> head_x = tx;
-        node -> children[node -> children_count - 1] -> head_y = ty;
-
-        node -> children[node -> children_count - 1] -> parent = node;
-
-        node -> children[node -> children_count - 1] -> parent_index =
-            node -> children_count - 1;
-        
-        node -> children[node -> children_count - 1] -> distance_runned =
-            node -> distance_runned + 1;
-
-        maze -> matrix[node -> head_y][node -> head_x].type = BODY;
-        maze -> matrix[ty][tx].type = LIVE_HEAD;
-        maze -> matrix[ty][tx].distance_runned = node -> distance_runned + 1;
-        
-        if (ty == maze -> end_y && tx == maze -> end_x)
-        {
-            end_reached = true;
-        }
-    }
-    
-    return end_reached ? NODE_END_REACHED : node -> children_count > 0 ?
-                NODE_MOVED : NODE_CANT_MOVE;
-}
-
 bool find_path(
-        SDL_Window *window, SDL_Renderer *renderer,
-        Tree *root, Maze *maze,
+        Display *display,
+        Tree *root, Arena *arena, Maze *maze,
         const Arguments *args)
 {
     // FPS calculation (on miliseconds)
@@ -386,17 +620,46 @@ bool find_path(
     uint8_t key;
 
     // FLAGS
+    bool window_changed = false;
     bool pause = false;
     bool running = true; 
-    bool end_reached = false;
-    bool atleast_one_node_moved = true;
-    Tree *winner_node = NULL;
+    bool show_hud = false;
+
+    // Stats of the frame being drawn, the HUD shows the ones of the last.
+    FrameStats stats = {0};
+    FrameStats last_stats = {0};
+    double first_frame_time = get_time_ms();
+    Trace trace;
+    if (args -> trace != NULL && !trace_open(&trace, args -> trace))
+    {
+        return false;
+    }
+
+    // The solver runs on the engine thread, each frame only grants it the
+    // steps it may take and draws what it published so far.
+    Engine engine;
+    if (!engine_start(&engine, args -> solver,
+                root, arena, maze, args -> threads))
+    {
+        if (args -> trace != NULL)
+        {
+            trace_close(&trace);
+        }
+
+        return false;
+    }
+
+    const int64_t steps = args -> steps_per_frame == 0 ?
+        ENGINE_UNLIMITED_STEPS : args -> steps_per_frame;
 
-    draw_maze(window, renderer, maze, args);
     while (running)
     {
         last_frame_time = SDL_GetTicks();
-        key = get_key();
+        double frame_start = get_time_ms();
+        stats.time_ms = frame_start - first_frame_time;
+        stats.draw_ms = stats.present_ms = 0;
+
+        key = get_key(&window_changed, &display -> view);
         if (key == USER_QUIT_EVENT)
         {
             running = false;
@@ -405,48 +668,64 @@ bool find_path(
         else if (key == USER_PAUSE_EVENT)
         {
             pause = !(pause);
+            engine_pause(&engine, pause);
         }
 
-        if (pause == false)
+        else if (key == USER_HUD_EVENT)
         {
-            if (end_reached)
-            {
-                if (winner_node != NULL)
-                {
-                    maze -> matrix
-                        [winner_node -> head_y][winner_node -> head_x].type =
-                            WIN_BLOCK;
-                    
-                    winner_node = winner_node -> parent;
-                }
-            }
+            show_hud = !(show_hud);
+            window_changed = true;
+        }
 
-            else if (atleast_one_node_moved)
-            {
-                atleast_one_node_moved = false;
-                Tree *node_to_mv = find_left_leaf(root);
-                do
-                {
-                    enum MOVE_STATES result = move_node(node_to_mv, maze);
-                    if (result == NODE_END_REACHED)
-                    {
-                        // Do not break yet, we want each node to move or be
-                        // dead on each turn.
-                        end_reached = true;
-                        winner_node = node_to_mv;
-                    }
+        if (pause == false && !engine_done(&engine))
+        {
+            engine_grant(&engine, steps);
+        }
 
-                    if (result == NODE_MOVED)
-                    {
-                        atleast_one_node_moved = true;
-                    }
+        // Even if it's paused window resizes need a full repaint, otherwise
+        // only the cells that changed are drawn, if any. The HUD changes
+        // every frame so it's drawn every frame, and a moved view is drawn
+        // from what's already known.
+        engine_lock_snapshot(&engine);
+        if (window_changed)
+        {
+            engine.snapshot_dirty.everything = true;
+            window_changed = false;
+        }
 
-                } while ((node_to_mv = find_next_leaf(node_to_mv)) != NULL);
+        bool redraw = show_hud || display -> view.changed ||
+            engine.snapshot_dirty.everything ||
+            engine.snapshot_dirty.count > 0;
+        if (redraw)
+        {
+            double draw_start = get_time_ms();
+            draw_maze(display, engine.snapshot, &engine.snapshot_dirty);
+            stats.draw_ms = get_time_ms() - draw_start;
+        }
+
+        engine_take_stats(&engine, &stats.engine);
+        engine_unlock_snapshot(&engine);
+
+        if (redraw)
+        {
+            if (show_hud)
+            {
+                hud_draw(display -> renderer, &last_stats);
             }
+
+            double present_start = get_time_ms();
+            SDL_RenderPresent(display -> renderer);
+            stats.present_ms = get_time_ms() - present_start;
+        }
+
+        stats.frame_ms = get_time_ms() - frame_start;
+        if (args -> trace != NULL)
+        {
+            trace_push(&trace, &stats);
         }
 
-        // It needs to be render even if it's paused due to window resizes.
-        draw_maze(window, renderer, maze, args);
+        last_stats = stats;
+        stats.frame += 1;
 
         delay = SDL_GetTicks() - last_frame_time;
         time_to_wait = ms_per_frame - delay;
@@ -454,326 +733,226 @@ bool find_path(
             SDL_Delay(time_to_wait);
     }
 
-    return end_reached;
-}
-
-void draw_maze(
-        SDL_Window *window,
-        SDL_Renderer *renderer,
-        const Maze *maze,
-        const Arguments *args)
-{
-    int32_t window_width, window_height;
-    SDL_GetWindowSize(window, &window_width, &window_height);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 1);
-    SDL_RenderClear(renderer);
-    int cell_lenght = fmin(window_width / maze -> columns,
-                            window_height / maze -> rows);
-    int padding_x = (window_width - cell_lenght * maze -> columns) / 2;
-    int padding_y = (window_height - cell_lenght * maze -> rows) / 2;
-
-    SDL_Rect square =
+    if (args -> trace != NULL)
     {
-        .x = padding_x,
-        .y = padding_y,
-        .w = cell_lenght,
-        .h = cell_lenght,
-    };
-
-    int r, g, b;
-
-    // The distance between the start node and end node can be actually bigger
-    // or smaller due to 'S' shaped mazes, I decided it that using this number
-    // for coloring the distance runned by a node is good.
-    int16_t max_distance_runned = (maze -> rows * maze -> columns) / 5;
-
-    for (int16_t row = 0; row < maze -> rows; row++)
-    {
-        for (int16_t column = 0; column < maze -> columns; column++)
+        int64_t dropped = trace_close(&trace);
+        if (dropped > 0)
         {
-            r = 255, g = 255, b = 255;
-            if (maze -> matrix[row][column].type == EMPTY)
-            {
-                r = 255, g = 255, b = 255;
-            }
-
-            // START of maze
-            else if (maze -> start_x == column && maze -> start_y == row)
-            {
-                r = 255, g = 127, b = 127;
-            }
-            
-            // END of maze
-            else if (maze -> end_x == column && maze -> end_y == row)
-            {
-                r = 255, g = 0, b = 0;
-            }
-
-            else if (maze -> matrix[row][column].type == WALL)
-            {
-                r = 0, g = 0, b = 0;
-            }
-
-            else if (maze -> matrix[row][column].type == LIVE_HEAD)
-            {
-                r = 255, g = 128, b = 255;
-            }
-
-            else if (maze -> matrix[row][column].type == DEAD_HEAD &&
-                    args -> show_dead_head)
-            {
-                r = 255, g = 0, b = 255;
-            }
-
-           else if (maze -> matrix[row][column].type == WIN_BLOCK)
-            {
-                r = 255, g = 255, b = 0;
-            }
-
-            else if(args -> show_body)
-            {
-                r = 0, g = 255, b = 0;
-                if (0.2 + maze -> matrix[row][column].distance_runned /
-                         (double)max_distance_runned <= 1.0)
-                {
-                    hsl_to_rgb(
-                            120,
-                            0.2 + maze -> matrix[row][column].distance_runned /
-                                (double)(max_distance_runned),
-                            0.5,
-                            &r, &g, &b);
-                }
-            }
-
-            else // No body show aka equal to EMPTY square.
-            {
-                r = 255, g = 255, b = 255;
-            }
-
-            SDL_SetRenderDrawColor(renderer, r, g, b, 255);
-            SDL_RenderFillRect(renderer, &square);
-            square.x += square.w;
+            fprintf(stderr, "Trace: %"PRId64" frames dropped\n", dropped);
         }
-        square.x = padding_x;
-        square.y += square.h;
     }
 
-    SDL_RenderPresent(renderer);
+    return engine_stop(&engine);
 }
 
-// From a given node finds the leftmost leaf.
-Tree * find_left_leaf(Tree * node)
+// Solves like find_path() but without window nor frame pacing, every
+// steps_per_frame steps (and on the first and last) the maze is drawn off
+// screen on a frame of the exporter, which encodes and writes it on its own
+// thread. Returns false if the export failed.
+bool export_path(
+        Tree *root, Arena *arena, Maze *maze,
+        const Arguments *args,
+        bool *found, int64_t *generations, int64_t *frames)
 {
-    while (node -> children_count != 0)
+    Display display =
+    {
+        .show_body = args -> show_body,
+        .show_dead_head = args -> show_dead_head,
+    };
+
+    if (!gradient_init(&display.gradient, args -> gradient, maze))
     {
-        node = node -> children[0];
+        return false;
     }
 
-    return node;
-}
+    // Frames smaller than the maze are drawn from the mipmap.
+    Exporter exporter;
+    Solver solver;
+    DirtyCells dirty;
+    if (!mipmap_init(&display.mipmap, maze))
+    {
+        gradient_free(&display.gradient);
+        return false;
+    }
 
-// Must be a leaf the node. (It works without being a leaf, but in the context
-// of a maze solving I prefer it being leaf)
-Tree * find_next_leaf(Tree *node)
-{
-    // A next leaf doesn't exist.
-    if (node -> parent == NULL)
+    if (!export_open(&exporter, args -> export,
+                args -> screen_width, args -> screen_height, args -> fps))
     {
-        return NULL;
+        display_free(&display);
+        gradient_free(&display.gradient);
+        return false;
     }
 
-    // Finding a parent node which is not the last child of his parent.
-    // Does that makes sense?
-    while(node -> parent_index == node -> parent -> children_count - 1)
+    // Starts with everything dirty, the first frame is drawn whole.
+    bool ok = solver_init(&solver, args -> solver,
+            root, arena, maze, args -> threads);
+    if (ok && !dirty_init(&dirty, DIRTY_CELLS_CAPACITY))
     {
-        node = node -> parent;
-        if (node -> parent == NULL)
-        {
-            return NULL;
-        }
+        solver_free(&solver);
+        ok = false;
     }
 
-    return find_left_leaf(node -> parent -> children[node -> parent_index +1]);
-}
+    if (!ok)
+    {
+        export_close(&exporter, frames);
+        display_free(&display);
+        gradient_free(&display.gradient);
+        return false;
+    }
 
-void nodes_info(
-        const Maze *maze,
-        int32_t *total, int32_t *live_head, int32_t *dead_head,
-        int32_t *distance_runned)
-{
-    for (int32_t row = 0; row < maze -> rows; row++)
+    // Same steps as the engine: the solver until the end is reached and then
+    // a cell of the winner path.
+    PathWalk walk = {0};
+    bool finished = false;
+    int64_t steps = 0;
+    ok = export_draw(&display, maze, &dirty, &exporter);
+    while (ok && !finished)
     {
-        for (int32_t column = 0; column < maze -> columns; column++)
+        size_t winner_cell;
+        if (solver.end_reached)
         {
-            Cell cell = maze -> matrix[row][column];
-            if (cell.type == EMPTY || cell.type == WALL || cell.type == END)
+            if (path_walk_next(&walk, maze, &winner_cell))
             {
-                continue;
+                maze -> types[winner_cell] = WIN_BLOCK;
+                dirty_push(&dirty, winner_cell);
             }
 
-            *total += 1;
-            if (cell.type == DEAD_HEAD)
-            {
-                *dead_head += 1;
-            }
+            finished = walk.done;
+        }
 
-            else if(cell.type == LIVE_HEAD)
-            {
-                *live_head += 1;
-            }
+        else if (solver_step(&solver, &dirty))
+        {
+            solver_path(&solver, &walk);
+            finished = walk.done;
+        }
 
-            if (cell.distance_runned >= *distance_runned)
-            {
-                *distance_runned = cell.distance_runned;
-            }
+        steps += 1;
+        if (finished || (args -> steps_per_frame > 0 &&
+                    steps % args -> steps_per_frame == 0))
+        {
+            ok = export_draw(&display, maze, &dirty, &exporter);
         }
     }
+
+    *found = solver.end_reached;
+    *generations += solver.steps;
+    ok = export_close(&exporter, frames) && ok;
+    dirty_free(&dirty);
+    solver_free(&solver);
+    display_free(&display);
+    gradient_free(&display.gradient);
+    return ok;
 }
 
-Maze * recursive_backtracker(int16_t rows, int16_t columns)
+// Draws the maze on the next free frame of exporter and hands it over.
+bool export_draw(
+        Display *display, const Maze *maze, DirtyCells *dirty,
+        Exporter *exporter)
 {
-    Maze * maze = (Maze *) malloc(sizeof(Maze));
-    maze -> rows = rows - (rows % 2 == 0);
-    maze -> columns = columns - (columns % 2 == 0);
-    maze -> matrix = malloc(sizeof(Cell*) * maze -> rows);
-    for (int16_t row = 0; row < maze -> rows; row++)
+    uint32_t *pixels = export_frame(exporter);
+    if (pixels == NULL || !draw_offscreen(display, maze, dirty,
+                pixels, exporter -> width, exporter -> height))
     {
-        maze -> matrix[row] = malloc(sizeof(Cell) * maze -> columns);
+        return false;
     }
-    
-    for (int16_t row = 0; row < maze -> rows; row++)
+
+    export_push(exporter);
+    return true;
+}
+
+// Loads the maze file or generates a new maze, checking and saving it if
+// asked. Saving has to happen before solving marks the grid.
+Maze * create_maze(const Arguments *args, Rng *rng)
+{
+    Maze *maze;
+    uint32_t generator = args -> generator;
+    uint64_t seed = args -> seed;
+    if (args -> load_maze != NULL)
     {
-        for (int16_t column = 0; column < maze -> columns; column++)
+        MazeFileHeader header;
+        maze = maze_file_load(args -> load_maze, args -> grid_file, &header);
+        if (maze != NULL)
         {
-            maze -> matrix[row][column].type =
-                row % 2 || column % 2 ? WALL : EMPTY;
-
-            maze -> matrix[row][column].distance_runned = 0;
+            generator = header.generator;
+            seed = header.seed;
+            printf("Loaded:      %s maze of seed %"PRIu64"\n",
+                    generator_name(generator), seed);
         }
     }
 
-    // TODO: Optimize max_size formula, it's actually less.
-    // X O X O X
-    // O X O X O
-    // X O X O X
-    // I could also just use realloc.
-    int32_t max_size = maze -> rows * maze -> columns;
-    int32_t **backtrack = malloc(sizeof(int32_t*) * max_size);
-    for (int32_t coord = 0; coord < max_size; coord++)
+    else
     {
-        // Pair of coordinates [X, Y]
-        backtrack[coord] = malloc(sizeof(int32_t) * 2);
-
-        // Coord doesn't exist
-        backtrack[coord][0] = -1;
-        backtrack[coord][1] = -1;
+        maze = generate_maze(args -> generator,
+                args -> maze_rows, args -> maze_columns, rng);
     }
 
-    int32_t backtrack_size = 1;
-    backtrack[0][0] = 0; // X
-    backtrack[0][1] = 0; // Y
-    maze -> matrix[0][0].type = VISITED;
-
-    // VALID and INVALID moves that a cell can do.
-    enum MAZE_MOVES moves[] = {LEFT, UP, DOWN, RIGHT};
-    size_t pos_move_quantity = sizeof(moves) / sizeof(enum MAZE_MOVES);
-    
-    // Moves that actually the user can do
-    enum MAZE_MOVES valid_moves[] = {-1, -1, -1, -1};
-    size_t valid_moves_count = 0;
-
-    int32_t current_x;
-    int32_t current_y;
-    int32_t new_x;
-    int32_t new_y;
-    int32_t wall_x; // The wall is the block between current and new cell.
-    int32_t wall_y;
-
-    do
+    if (maze == NULL)
     {
-        valid_moves_count = 0;
-        current_x = backtrack[backtrack_size - 1][0];
-        current_y = backtrack[backtrack_size - 1][1];
-
-        for (size_t move = 0; move < pos_move_quantity; move++)
-        {
-            // Checking for out of bounds
-            if ((moves[move] == LEFT && current_x <= 0) ||
-                (moves[move] == RIGHT &&
-                    current_x >= maze -> columns - 1) ||
-                (moves[move] == UP && current_y <= 0) ||
-                (moves[move] == DOWN && current_y >= maze -> rows - 1))
-            {
-                continue;
-            }
-
-            new_x = current_x + (moves[move] == LEFT ? -2 :
-                                moves[move] == RIGHT ? 2 : 0);
-
-            new_y = current_y + (moves[move] == UP ? -2 :
-                                moves[move] == DOWN ? 2 : 0);
-
-            if (maze -> matrix[new_y][new_x].type == EMPTY)
-            {
-                valid_moves[valid_moves_count] = moves[move];
-                valid_moves_count++;
-            }
-        }
-
-        if (valid_moves_count == 0)
-        {
-            backtrack_size--;
-        }
+        return NULL;
+    }
 
-        else
-        {
-            enum MAZE_MOVES mv = valid_moves[
-                                    SO_random(0, valid_moves_count-1)];
+    if ((args -> verify && !verify_maze(maze)) ||
+            (args -> save_maze != NULL &&
+             !maze_file_save(args -> save_maze, maze, generator, seed)))
+    {
+        maze_free(maze);
+        return NULL;
+    }
 
-            new_x = current_x + (mv == LEFT ? -2 : mv == RIGHT ? 2 : 0);
-            new_y = current_y + (mv == UP ? -2 : mv == DOWN ? 2 : 0);
+    return maze;
+}
 
-            backtrack[backtrack_size][0] = new_x;
-            backtrack[backtrack_size][1] = new_y;
-            maze -> matrix[new_y][new_x].type = VISITED;
-            wall_x = current_x + (mv == LEFT ? -1 : mv == RIGHT ? 1 : 0);
-            wall_y = current_y + (mv == UP ? -1 : mv == DOWN ? 1 : 0);
-            maze -> matrix[wall_y][wall_x].type = EMPTY;
-            backtrack_size++;
-        }
+// Worst case bytes needed to generate and solve a maze of rows x columns, on
+// double since the product can overflow even 64 bits.
+double estimate_memory(const Arguments *args)
+{
+    int32_t rows = args -> maze_rows - (args -> maze_rows % 2 == 0);
+    int32_t columns = args -> maze_columns - (args -> maze_columns % 2 == 0);
+
+    double cells = (double)rows * columns;
+
+    // A mapped grid is paged to its file, loading only needs a row.
+    double grid = args -> grid_file != NULL ? 0 : cells * MAZE_BYTES_PER_CELL;
+    double scratch = args -> load_maze != NULL ? maze_file_row_bytes(columns) :
+        generator_scratch_memory(args -> generator, rows, columns);
+    double solver = solver_memory(args -> solver, rows, columns);
+    double screen = (double)sizeof(uint32_t) *
+        args -> screen_width * args -> screen_height;
+
+    // What's drawn is allocated before solving starts and kept until the end.
+    double drawing = 0;
+    if (args -> export != NULL)
+    {
+        drawing = mipmap_memory(rows, columns) + screen +
+            export_memory(args -> export,
+                    args -> screen_width, args -> screen_height);
     }
-    while (backtrack_size > 1);
 
-    // Set the visited cells used for backtracking to empty cells.
-    for (int16_t row = 0; row < maze -> rows; row++)
+    else if (!args -> headless && args -> batch == 0)
     {
-        for (int16_t column = 0; column < maze -> columns; column++)
+        // The engine draws from a snapshot, a second grid always in memory,
+        // and the texture renderer keeps a copy of the texture, the mipmap
+        // and the screen composed from it.
+        drawing = cells * MAZE_BYTES_PER_CELL;
+        if (args -> renderer == RENDERER_TEXTURE)
         {
-            if (maze -> matrix[row][column].type == VISITED)
-            {
-                maze -> matrix[row][column].type = EMPTY;
-            }
+            drawing += cells * sizeof(uint32_t) +
+                mipmap_memory(rows, columns) + screen;
         }
     }
 
-    // Freeing 2d backtrack
-    for (int32_t coord = 0; coord < max_size; coord++)
-    {
-        free(backtrack[coord]);
-    }
-    free(backtrack);
-
-    // Setting start and end of the maze.
-    // Start is top left corner
-    // End is bottom right corner.
-    maze -> start_x = 0;
-    maze -> start_y = 0;
-    maze -> end_x = maze -> columns - 1;
-    maze -> end_y = maze -> rows - 1;
-    maze -> matrix[maze -> start_y][maze -> start_x].type = START;
-    maze -> matrix[maze -> end_y][maze -> end_x].type = END;
-    
-    return maze;
+    // The generator scratch is freed before solving starts, --verify needs
+    // less than the tree.
+    return grid + drawing + (scratch > solver ? scratch : solver);
+}
+
+// Prints whether the maze is perfect, if it isn't the solver results would
+// mean nothing.
+bool verify_maze(const Maze *maze)
+{
+    bool perfect = maze_is_perfect(maze);
+    printf("Perfect:     %s\n", perfect ? "yes" : "no");
+    return perfect;
 }
 
 static error_t parse_opt(int32_t key, char *arg, struct argp_state *state)
@@ -793,7 +972,8 @@ static error_t parse_opt(int32_t key, char *arg, struct argp_state *state)
             break;
         
         case OPTION_SCREEN_HEIGHT: case OPTION_SCREEN_WIDTH:
-        case 'c': case 'r': case 'f':
+        case 'c': case 'r': case 'f': case OPTION_THREADS:
+        case OPTION_STEPS_PER_FRAME: case OPTION_BATCH: case OPTION_JOBS:
             long val = strtol(arg, &endptr, 10);
             if (errno != 0 || endptr == arg || *endptr != '\0')
             {
@@ -801,7 +981,28 @@ static error_t parse_opt(int32_t key, char *arg, struct argp_state *state)
                         "arg: |%s|\n", arg);
                 exit(EXIT_FAILURE);
             }
-            else if (val <= 0 || val > INT16_MAX)
+            // Maze dimensions and batches go up to 32 bits, the rest is
+            // still 16 bits.
+            else if ((key == 'c' || key == 'r' || key == OPTION_BATCH) &&
+                    (val <= 0 || val > INT32_MAX))
+            {
+                fprintf(state -> out_stream,
+                        "Value must be between [1, %"PRIi32"]\n", INT32_MAX);
+                exit(EXIT_FAILURE);
+            }
+
+            // 0 steps per frame means as fast as possible.
+            else if (key == OPTION_STEPS_PER_FRAME &&
+                    (val < 0 || val > INT32_MAX))
+            {
+                fprintf(state -> out_stream,
+                        "Value must be between [0, %"PRIi32"]\n", INT32_MAX);
+                exit(EXIT_FAILURE);
+            }
+
+            else if (key != 'c' && key != 'r' && key != OPTION_BATCH &&
+                    key != OPTION_STEPS_PER_FRAME &&
+                    (val <= 0 || val > INT16_MAX))
             {
                 fprintf(state -> out_stream,
                         "Value must be between [1, %"PRIi16"]\n", INT16_MAX);
@@ -823,6 +1024,16 @@ static error_t parse_opt(int32_t key, char *arg, struct argp_state *state)
                 args -> maze_rows = val;
             }
 
+            else if (key == OPTION_BATCH)
+            {
+                args -> batch = val;
+            }
+
+            else if (key == OPTION_JOBS)
+            {
+                args -> jobs = val;
+            }
+
             else if (key == OPTION_SCREEN_HEIGHT)
             {
                 args -> screen_height = val;
@@ -832,6 +1043,178 @@ static error_t parse_opt(int32_t key, char *arg, struct argp_state *state)
             {
                 args -> screen_width = val;
             }
+
+            else if (key == OPTION_THREADS)
+            {
+                args -> threads = val;
+            }
+
+            else if (key == OPTION_STEPS_PER_FRAME)
+            {
+                args -> steps_per_frame = val;
+            }
+            break;
+
+        case OPTION_HEADLESS:
+            args -> headless = true;
+            break;
+
+        case OPTION_VERIFY:
+            args -> verify = true;
+            break;
+
+        case OPTION_STREAM_MAZE:
+            args -> stream_maze = arg;
+            break;
+
+        case OPTION_LOAD_MAZE:
+            args -> load_maze = arg;
+            break;
+
+        case OPTION_GRID_FILE:
+            args -> grid_file = arg;
+            break;
+
+        case OPTION_SAVE_MAZE:
+            args -> save_maze = arg;
+            break;
+
+        case OPTION_TRACE:
+            args -> trace = arg;
+            break;
+
+        case OPTION_EXPORT:
+            args -> export = arg;
+            break;
+
+        case OPTION_SEED:
+            args -> seed = strtoull(arg, &endptr, 10);
+            if (errno != 0 || endptr == arg || *endptr != '\0' ||
+                    arg[0] == '-')
+            {
+                fprintf(state -> out_stream, "Error in conversion of "
+                        "arg: |%s|\n", arg);
+                exit(EXIT_FAILURE);
+            }
+
+            args -> has_seed = true;
+            break;
+
+        case OPTION_GENERATOR:
+            if (strcmp(arg, "backtracker") == 0)
+            {
+                args -> generator = GENERATOR_BACKTRACKER;
+            }
+
+            else if (strcmp(arg, "kruskal") == 0)
+            {
+                args -> generator = GENERATOR_KRUSKAL;
+            }
+
+            else if (strcmp(arg, "wilson") == 0)
+            {
+                args -> generator = GENERATOR_WILSON;
+            }
+
+            else if (strcmp(arg, "eller") == 0)
+            {
+                args -> generator = GENERATOR_ELLER;
+            }
+
+            else
+            {
+                fprintf(state -> out_stream, "Generator must be "
+                        "[backtracker, kruskal, wilson or eller]\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case OPTION_SOLVER:
+            if (strcmp(arg, "forking") == 0)
+            {
+                args -> solver = SOLVER_FORKING;
+            }
+
+            else if (strcmp(arg, "bidirectional") == 0)
+            {
+                args -> solver = SOLVER_BIDIRECTIONAL;
+            }
+
+            else if (strcmp(arg, "astar") == 0)
+            {
+                args -> solver = SOLVER_ASTAR;
+            }
+
+            else if (strcmp(arg, "jps") == 0)
+            {
+                args -> solver = SOLVER_JPS;
+            }
+
+            else if (strcmp(arg, "junctions") == 0)
+            {
+                args -> solver = SOLVER_JUNCTIONS;
+            }
+
+            else if (strcmp(arg, "compact") == 0)
+            {
+                args -> solver = SOLVER_COMPACT;
+            }
+
+            else if (strcmp(arg, "bitboard") == 0)
+            {
+                args -> solver = SOLVER_BITBOARD;
+            }
+
+            else
+            {
+                fprintf(state -> out_stream, "Solver must be "
+                        "[forking, bidirectional, astar, jps, junctions, "
+                        "compact or bitboard]\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case OPTION_GRADIENT:
+            if (strcmp(arg, "green") == 0)
+            {
+                args -> gradient = GRADIENT_GREEN;
+            }
+
+            else if (strcmp(arg, "rainbow") == 0)
+            {
+                args -> gradient = GRADIENT_RAINBOW;
+            }
+
+            else if (strcmp(arg, "cycle") == 0)
+            {
+                args -> gradient = GRADIENT_CYCLE;
+            }
+
+            else
+            {
+                fprintf(state -> out_stream,
+                        "Gradient must be [green, rainbow or cycle]\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case OPTION_RENDERER:
+            if (strcmp(arg, "texture") == 0)
+            {
+                args -> renderer = RENDERER_TEXTURE;
+            }
+
+            else if (strcmp(arg, "rects") == 0)
+            {
+                args -> renderer = RENDERER_RECTS;
+            }
+
+            else
+            {
+                fprintf(state -> out_stream,
+                        "Renderer must be [texture or rects]\n");
+                exit(EXIT_FAILURE);
+            }
             break;
 
         case OPTION_FULLSCREEN: case OPTION_SHOW_BODY:
@@ -880,24 +1263,6 @@ static error_t parse_opt(int32_t key, char *arg, struct argp_state *state)
     return 0;
 }
 
-// https://en.wikipedia.org/wiki/HSL_and_HSV#HSL_to_RGB
-// Recommendations for good rainbows
-void hsl_to_rgb(double hue, double saturation, double lightness,
-        int *r, int *g, int *b)
-{
-    double a = saturation * fmin(lightness, 1 - lightness);
-    double k = (int)(0 + hue / 30.0) % 12;
-    *r = 255 * (lightness - a * fmax(-1, fmin(fmin(k - 3, 9 - k), 1)));
-
-    k = (int)(8 + hue / 30.0) % 12;
-    *g = 255 * (lightness - a * fmax(-1, fmin(fmin(k - 3, 9 - k), 1)));
-
-    k = (int)(4 + hue / 30.0) % 12;
-    *b = 255 * (lightness - a * fmax(-1, fmin(fmin(k - 3, 9 - k), 1)));
-
-    // Multiply r, g, b by 255 because these were on [0, 1] interval.
-}
-
 /*
  * Function: get_key
  * ----------------------
@@ -905,13 +1270,16 @@ void hsl_to_rgb(double hue, double saturation, double lightness,
  *
  * Parameters:
  * -----------
- *  none aka void.
+ *  window_changed: set to true if the window got resized or exposed, so it
+ *                  must be repainted entirely.
+ *  view:           panned with the arrows or WASD, zoomed with +, - or the
+ *                  mouse wheel and fitted back to the window with 0.
  *
  * returns: uint8_t constant indicating action of event
- * (QUIT, PAUSE or UNKNOWN)
+ * (QUIT, PAUSE, HUD or UNKNOWN)
  *
  */
-uint8_t get_key(void)
+uint8_t get_key(bool *window_changed, Viewport *view)
 {
     SDL_Event event;
     uint8_t result = USER_UNKNOWN_EVENT;
@@ -937,17 +1305,70 @@ uint8_t get_key(void)
                     {
                         result = USER_PAUSE_EVENT;
                     }
+
+                    else if (key_code == SDLK_h)
+                    {
+                        result = USER_HUD_EVENT;
+                    }
+
+                    else if (key_code == SDLK_LEFT || key_code == SDLK_a)
+                    {
+                        viewport_pan(view, -1, 0);
+                    }
+
+                    else if (key_code == SDLK_RIGHT || key_code == SDLK_d)
+                    {
+                        viewport_pan(view, 1, 0);
+                    }
+
+                    else if (key_code == SDLK_UP || key_code == SDLK_w)
+                    {
+                        viewport_pan(view, 0, -1);
+                    }
+
+                    else if (key_code == SDLK_DOWN || key_code == SDLK_s)
+                    {
+                        viewport_pan(view, 0, 1);
+                    }
+
+                    else if (key_code == SDLK_PLUS ||
+                            key_code == SDLK_EQUALS ||
+                            key_code == SDLK_KP_PLUS)
+                    {
+                        viewport_zoom(view, 1);
+                    }
+
+                    else if (key_code == SDLK_MINUS ||
+                            key_code == SDLK_KP_MINUS)
+                    {
+                        viewport_zoom(view, -1);
+                    }
+
+                    else if (key_code == SDLK_0)
+                    {
+                        viewport_fit(view);
+                    }
                     break;
                 }
+
+            case SDL_MOUSEWHEEL:
+                if (event.wheel.y != 0)
+                {
+                    viewport_zoom(view, event.wheel.y);
+                }
+                break;
+
+            case SDL_WINDOWEVENT:
+                if (event.window.event == SDL_WINDOWEVENT_EXPOSED ||
+                    event.window.event == SDL_WINDOWEVENT_RESIZED ||
+                    event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                {
+                    *window_changed = true;
+                }
+                break;
+
             default: {}
         }
     }
     return result;
 }
-
-// I was using prior to this the typical rand() % N
-// https://stackoverflow.com/questions/1202687/how-do-i-get-a-specific-range-of-numbers-from-rand#1202706
-int SO_random(int min, int max)
-{
-   return min + rand() / (RAND_MAX / (max - min + 1) + 1);
-}
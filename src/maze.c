@@ -0,0 +1,131 @@
+// mmap, ftruncate and open aren't part of c99.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc, calloc and free.
+#include <string.h>     // memcpy.
+#include <fcntl.h>      // open.
+#include <unistd.h>     // ftruncate and close.
+#include <sys/mman.h>   // mmap and munmap.
+#include "maze.h"
+
+// Every cell starts as EMPTY with 0 distance runned.
+Maze * maze_create(int32_t rows, int32_t columns)
+{
+    Maze *maze = malloc(sizeof(Maze));
+    if (maze == NULL)
+    {
+        perror("Failed to allocate memory for maze\n");
+        return NULL;
+    }
+
+    maze -> rows = rows;
+    maze -> columns = columns;
+    maze -> start_x = maze -> start_y = -1;
+    maze -> end_x = maze -> end_y = -1;
+    maze -> mapped_bytes = 0;
+    maze -> types = calloc(maze_cells(maze), sizeof(uint8_t));
+    maze -> distances_runned = calloc(maze_cells(maze), sizeof(uint32_t));
+    if (maze -> types == NULL || maze -> distances_runned == NULL)
+    {
+        perror("Failed to allocate memory for maze grid\n");
+        maze_free(maze);
+        return NULL;
+    }
+
+    return maze;
+}
+
+// Same as maze_create() but both planes are mapped on the file at path, so a
+// grid bigger than the memory is paged to disk by the kernel instead.
+// The file is truncated to hold the grid, it's sparse so every cell starts as
+// EMPTY with 0 distance runned too.
+Maze * maze_create_mapped(int32_t rows, int32_t columns, const char *path)
+{
+    Maze *maze = malloc(sizeof(Maze));
+    if (maze == NULL)
+    {
+        perror("Failed to allocate memory for maze\n");
+        return NULL;
+    }
+
+    maze -> rows = rows;
+    maze -> columns = columns;
+    maze -> start_x = maze -> start_y = -1;
+    maze -> end_x = maze -> end_y = -1;
+
+    // Distances are kept aligned after the types.
+    size_t types_bytes = maze_cells(maze) * sizeof(uint8_t);
+    types_bytes += (sizeof(uint32_t) - types_bytes % sizeof(uint32_t)) %
+                    sizeof(uint32_t);
+    maze -> mapped_bytes = types_bytes + maze_cells(maze) * sizeof(uint32_t);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        perror("Failed to open maze grid file\n");
+        free(maze);
+        return NULL;
+    }
+
+    if (ftruncate(fd, maze -> mapped_bytes) != 0)
+    {
+        perror("Failed to resize maze grid file\n");
+        close(fd);
+        free(maze);
+        return NULL;
+    }
+
+    uint8_t *planes = mmap(NULL, maze -> mapped_bytes,
+            PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (planes == MAP_FAILED)
+    {
+        perror("Failed to map maze grid file\n");
+        free(maze);
+        return NULL;
+    }
+
+    maze -> types = planes;
+    maze -> distances_runned = (uint32_t*)(planes + types_bytes);
+    return maze;
+}
+
+Maze * maze_clone(const Maze *maze)
+{
+    Maze *clone = maze_create(maze -> rows, maze -> columns);
+    if (clone == NULL)
+    {
+        return NULL;
+    }
+
+    clone -> start_x = maze -> start_x;
+    clone -> start_y = maze -> start_y;
+    clone -> end_x = maze -> end_x;
+    clone -> end_y = maze -> end_y;
+    memcpy(clone -> types, maze -> types, maze_cells(maze) * sizeof(uint8_t));
+    memcpy(clone -> distances_runned, maze -> distances_runned,
+            maze_cells(maze) * sizeof(uint32_t));
+    return clone;
+}
+
+void maze_free(Maze *maze)
+{
+    if (maze == NULL)
+    {
+        return;
+    }
+
+    if (maze -> mapped_bytes > 0)
+    {
+        munmap(maze -> types, maze -> mapped_bytes);
+    }
+
+    else
+    {
+        free(maze -> types);
+        free(maze -> distances_runned);
+    }
+
+    free(maze);
+}
@@ -0,0 +1,81 @@
+#ifndef MAZE_H
+#define MAZE_H
+
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include <stdint.h>     // UINT32_MAX.
+
+enum MAZE_LEGEND
+{
+    EMPTY,
+    WALL,
+    BODY,
+    DEAD_HEAD,
+    LIVE_HEAD,
+    START,
+    END,
+    WIN_BLOCK,
+    VISITED,    // Visited is only used on generating the maze
+                // recursive_backtracker() and wilson()
+    CLAIMED,    // Claimed and contested are only used inside a generation
+    CONTESTED,  // of the parallel solver, parallel_solver_step()
+    END_BODY,       // Same as BODY, DEAD_HEAD and LIVE_HEAD for the tree
+    END_DEAD_HEAD,  // grown from END by the bidirectional solver.
+    END_LIVE_HEAD
+};
+
+// The grid is split in row-major planes, one allocation each (one mapping for
+// both with maze_create_mapped()), so the cell type that is checked the most
+// fits in a byte and it's not interleaved with the distance.
+// Cell (x, y) lives at maze_index(maze, x, y) of every plane, indices are
+// size_t so mazes can have more cells than fit on 32 bits.
+typedef struct Maze
+{
+    uint8_t *types;                 // enum MAZE_LEGEND of each cell.
+    uint32_t *distances_runned;     // Distance from start of each cell.
+    int32_t rows;
+    int32_t columns;
+    int32_t start_x, start_y;
+    int32_t end_x, end_y;
+    size_t mapped_bytes;            // 0 unless the planes live on a file.
+
+} Maze;
+
+// Bytes per cell used by the planes of the grid.
+#define MAZE_BYTES_PER_CELL (sizeof(uint8_t) + sizeof(uint32_t))
+
+Maze * maze_create(int32_t rows, int32_t columns);
+Maze * maze_create_mapped(int32_t rows, int32_t columns, const char *path);
+Maze * maze_clone(const Maze *maze);
+void maze_free(Maze *maze);
+
+static inline size_t maze_cells(const Maze *maze)
+{
+    return (size_t)maze -> rows * maze -> columns;
+}
+
+static inline size_t maze_index(const Maze *maze, int32_t x, int32_t y)
+{
+    return (size_t)y * maze -> columns + x;
+}
+
+static inline int32_t maze_index_x(const Maze *maze, size_t index)
+{
+    return index % maze -> columns;
+}
+
+static inline int32_t maze_index_y(const Maze *maze, size_t index)
+{
+    return index / maze -> columns;
+}
+
+// The distance plane is 4 bytes per cell to keep huge grids affordable, a
+// distance that doesn't fit (it would need a path of more than 4 billion
+// cells) is clamped, it's only used for coloring and the summary.
+static inline void maze_set_distance(Maze *maze, size_t index, int64_t distance)
+{
+    maze -> distances_runned[index] =
+        distance > UINT32_MAX ? UINT32_MAX : (uint32_t)distance;
+}
+
+#endif // MAZE_H
@@ -0,0 +1,563 @@
+// Same result as forking_step() but with the generation split across threads.
+// forking_step() moves heads in frontier order and the first one that reaches
+// an EMPTY cell takes it, so a generation here is done in phases:
+//  - PROPOSE: every head marks its EMPTY neighbours as CLAIMED, a cell claimed
+//    twice becomes CONTESTED.
+//  - CONTEST: only if something got contested, heads collect their contested
+//    neighbours and then they are given, in frontier order, to the first head
+//    that wanted them.
+//  - EXPAND: every head creates a child on each cell it won, in move order.
+// Children are gathered per chunk and chunks are merged in frontier order, so
+// the tree, the distances and the winner are the same as single threaded.
+// On a perfect maze two heads can't share a neighbour (it would be a loop),
+// so contests only happen on mazes with loops.
+
+// pthread_barrier_t isn't part of c99.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc, realloc, calloc and free.
+#include <errno.h>      // global error variable "errno".
+#include "parallel-solver.h"
+
+static void free_init(ParallelSolver *solver, int32_t arenas);
+static void * worker_loop(void *data);
+static void run_phase(ParallelSolver *solver, int32_t worker);
+static void dispatch(ParallelSolver *solver, enum PARALLEL_PHASES phase);
+static bool take_chunk(ParallelSolver *solver, int32_t worker, size_t *chunk);
+static bool reserve_chunks(ParallelSolver *solver, size_t chunks);
+static void propose(ParallelSolver *solver, size_t chunk);
+static void contest(ParallelSolver *solver, size_t chunk);
+static void resolve_contests(ParallelSolver *solver);
+static void expand(ParallelSolver *solver, int32_t worker, size_t chunk);
+static bool target_cell(
+        const Maze *maze, const Tree *node,
+        size_t move, size_t *target);
+
+// Same order as move_node(), children must be created in this order.
+static const enum MAZE_MOVES moves[MAX_MOVES] = {LEFT, UP, DOWN, RIGHT};
+
+bool parallel_solver_init(ParallelSolver *solver, int32_t threads)
+{
+    solver -> threads = threads;
+    solver -> chunks = solver -> chunks_capacity = 0;
+    solver -> children = NULL;
+    solver -> children_count = NULL;
+    solver -> conflicts = NULL;
+    solver -> conflicts_count = NULL;
+    solver -> last_end_head = NULL;
+    solver -> moved = NULL;
+    solver -> won_moves = NULL;
+
+    solver -> threads_ids = malloc(sizeof(pthread_t) * threads);
+    solver -> workers = malloc(sizeof(ParallelWorker) * threads);
+    solver -> arenas = malloc(sizeof(Arena) * threads);
+    solver -> ranges = calloc(threads, sizeof(uint64_t));
+    if (solver -> threads_ids == NULL || solver -> workers == NULL ||
+        solver -> arenas == NULL || solver -> ranges == NULL)
+    {
+        perror("Failed to allocate memory for parallel solver\n");
+        free_init(solver, 0);
+        return false;
+    }
+
+    for (int32_t worker = 0; worker < threads; worker++)
+    {
+        solver -> workers[worker].solver = solver;
+        solver -> workers[worker].id = worker;
+        if (!arena_init(&solver -> arenas[worker],
+                    sizeof(Tree) * TREE_ARENA_BLOCK_NODES))
+        {
+            perror("Failed to allocate memory for parallel solver arena\n");
+            free_init(solver, worker);
+            return false;
+        }
+    }
+
+    // pthread returns the error instead of setting errno.
+    int error = pthread_barrier_init(&solver -> phase_start, NULL, threads);
+    if (error == 0)
+    {
+        error = pthread_barrier_init(&solver -> phase_done, NULL, threads);
+        if (error != 0)
+        {
+            pthread_barrier_destroy(&solver -> phase_start);
+        }
+    }
+
+    if (error != 0)
+    {
+        errno = error;
+        perror("Failed to create parallel solver barriers\n");
+        free_init(solver, threads);
+        return false;
+    }
+
+    for (int32_t worker = 1; worker < threads; worker++)
+    {
+        if (pthread_create(&solver -> threads_ids[worker], NULL,
+                    worker_loop, &solver -> workers[worker]) != 0)
+        {
+            perror("Failed to create worker thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return true;
+}
+
+bool parallel_solver_step(
+        ParallelSolver *solver,
+        Frontier *frontier, Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node)
+{
+    if (frontier -> heads_count < PARALLEL_MIN_HEADS)
+    {
+        return forking_step(
+                frontier, arena, maze, dirty, end_reached, winner_node);
+    }
+
+    size_t chunks = (frontier -> heads_count + PARALLEL_CHUNK_HEADS - 1) /
+                        PARALLEL_CHUNK_HEADS;
+
+    if (!reserve_chunks(solver, chunks))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    solver -> frontier = frontier;
+    solver -> maze = maze;
+    solver -> chunks = chunks;
+    solver -> contested = false;
+
+    dispatch(solver, PHASE_PROPOSE);
+    if (solver -> contested)
+    {
+        dispatch(solver, PHASE_CONTEST);
+        resolve_contests(solver);
+    }
+    dispatch(solver, PHASE_EXPAND);
+
+    // Merge in frontier order, then it's like every head moved in order.
+    bool atleast_one_node_moved = false;
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+    {
+        Tree **children =
+            solver -> children + chunk * PARALLEL_CHUNK_HEADS * MAX_MOVES;
+
+        for (size_t child = 0; child < solver -> children_count[chunk];
+                child++)
+        {
+            frontier_push(frontier, children[child]);
+            if (dirty != NULL)
+            {
+                dirty_push(dirty, maze_index(maze,
+                            children[child] -> head_x,
+                            children[child] -> head_y));
+            }
+        }
+
+        if (solver -> last_end_head[chunk] != -1)
+        {
+            // Do not stop yet, like forking_step() the last one wins.
+            *end_reached = true;
+            *winner_node = frontier -> heads[solver -> last_end_head[chunk]];
+        }
+
+        atleast_one_node_moved |= solver -> moved[chunk];
+    }
+
+    if (dirty != NULL)
+    {
+        for (size_t head = 0; head < frontier -> heads_count; head++)
+        {
+            dirty_push(dirty, maze_index(maze,
+                        frontier -> heads[head] -> head_x,
+                        frontier -> heads[head] -> head_y));
+        }
+    }
+
+    frontier_swap(frontier);
+    return atleast_one_node_moved;
+}
+
+// The nodes created by the workers live on their arenas, the tree can't be
+// used after this.
+void parallel_solver_free(ParallelSolver *solver)
+{
+    dispatch(solver, PHASE_QUIT);
+    for (int32_t worker = 1; worker < solver -> threads; worker++)
+    {
+        pthread_join(solver -> threads_ids[worker], NULL);
+    }
+
+    for (int32_t worker = 0; worker < solver -> threads; worker++)
+    {
+        arena_free(&solver -> arenas[worker]);
+    }
+
+    pthread_barrier_destroy(&solver -> phase_start);
+    pthread_barrier_destroy(&solver -> phase_done);
+    free(solver -> threads_ids);
+    free(solver -> workers);
+    free(solver -> arenas);
+    free(solver -> ranges);
+    free(solver -> children);
+    free(solver -> children_count);
+    free(solver -> conflicts);
+    free(solver -> conflicts_count);
+    free(solver -> last_end_head);
+    free(solver -> moved);
+    free(solver -> won_moves);
+}
+
+// Undoes a parallel_solver_init() that failed after its first arenas.
+static void free_init(ParallelSolver *solver, int32_t arenas)
+{
+    for (int32_t worker = 0; worker < arenas; worker++)
+    {
+        arena_free(&solver -> arenas[worker]);
+    }
+
+    free(solver -> threads_ids);
+    free(solver -> workers);
+    free(solver -> arenas);
+    free(solver -> ranges);
+}
+
+static void * worker_loop(void *data)
+{
+    ParallelWorker *worker = data;
+    ParallelSolver *solver = worker -> solver;
+    while (true)
+    {
+        pthread_barrier_wait(&solver -> phase_start);
+        if (solver -> phase == PHASE_QUIT)
+        {
+            break;
+        }
+
+        run_phase(solver, worker -> id);
+        pthread_barrier_wait(&solver -> phase_done);
+    }
+
+    return NULL;
+}
+
+// Splits the chunks evenly and runs the phase on every worker, returns once
+// all of them are done.
+static void dispatch(ParallelSolver *solver, enum PARALLEL_PHASES phase)
+{
+    solver -> phase = phase;
+    for (int32_t worker = 0; worker < solver -> threads; worker++)
+    {
+        uint64_t begin = solver -> chunks * worker / solver -> threads;
+        uint64_t end = solver -> chunks * (worker + 1) / solver -> threads;
+        solver -> ranges[worker] = begin << 32 | end;
+    }
+
+    pthread_barrier_wait(&solver -> phase_start);
+    if (phase == PHASE_QUIT)
+    {
+        return;
+    }
+
+    run_phase(solver, 0);
+    pthread_barrier_wait(&solver -> phase_done);
+}
+
+static void run_phase(ParallelSolver *solver, int32_t worker)
+{
+    size_t chunk;
+    while (take_chunk(solver, worker, &chunk))
+    {
+        if (solver -> phase == PHASE_PROPOSE)
+        {
+            propose(solver, chunk);
+        }
+
+        else if (solver -> phase == PHASE_CONTEST)
+        {
+            contest(solver, chunk);
+        }
+
+        else
+        {
+            expand(solver, worker, chunk);
+        }
+    }
+}
+
+// Own chunks are taken from the beginning of the range, stolen ones from the
+// end so the owner and the thief rarely fight for the same one.
+static bool take_chunk(ParallelSolver *solver, int32_t worker, size_t *chunk)
+{
+    for (int32_t offset = 0; offset < solver -> threads; offset++)
+    {
+        int32_t victim = (worker + offset) % solver -> threads;
+        uint64_t range =
+            __atomic_load_n(&solver -> ranges[victim], __ATOMIC_ACQUIRE);
+
+        while ((range >> 32) < (uint32_t)range)
+        {
+            uint64_t begin = range >> 32;
+            uint64_t end = (uint32_t)range;
+            uint64_t taken = offset == 0 ? (begin + 1) << 32 | end :
+                                            begin << 32 | (end - 1);
+
+            if (__atomic_compare_exchange_n(&solver -> ranges[victim],
+                        &range, taken, false,
+                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                *chunk = offset == 0 ? begin : end - 1;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static bool reserve_chunks(ParallelSolver *solver, size_t chunks)
+{
+    if (chunks <= solver -> chunks_capacity)
+    {
+        return true;
+    }
+
+    size_t capacity = solver -> chunks_capacity ? solver -> chunks_capacity : 1;
+    while (capacity < chunks)
+    {
+        capacity *= 2;
+    }
+
+    size_t slots = capacity * PARALLEL_CHUNK_HEADS * MAX_MOVES;
+    solver -> children =
+        realloc(solver -> children, sizeof(Tree*) * slots);
+    solver -> conflicts =
+        realloc(solver -> conflicts, sizeof(uint32_t) * slots);
+    solver -> children_count =
+        realloc(solver -> children_count, sizeof(size_t) * capacity);
+    solver -> conflicts_count =
+        realloc(solver -> conflicts_count, sizeof(size_t) * capacity);
+    solver -> last_end_head =
+        realloc(solver -> last_end_head, sizeof(int64_t) * capacity);
+    solver -> moved = realloc(solver -> moved, sizeof(bool) * capacity);
+    solver -> won_moves = realloc(solver -> won_moves,
+            sizeof(uint8_t) * capacity * PARALLEL_CHUNK_HEADS);
+
+    if (solver -> children == NULL || solver -> conflicts == NULL ||
+        solver -> children_count == NULL ||
+        solver -> conflicts_count == NULL ||
+        solver -> last_end_head == NULL || solver -> moved == NULL ||
+        solver -> won_moves == NULL)
+    {
+        perror("Failed to allocate memory for parallel solver\n");
+        return false;
+    }
+
+    solver -> chunks_capacity = capacity;
+    return true;
+}
+
+// Heads of a chunk: [first, last).
+static void chunk_heads(
+        const ParallelSolver *solver, size_t chunk,
+        size_t *first, size_t *last)
+{
+    *first = chunk * PARALLEL_CHUNK_HEADS;
+    *last = *first + PARALLEL_CHUNK_HEADS;
+    if (*last > solver -> frontier -> heads_count)
+    {
+        *last = solver -> frontier -> heads_count;
+    }
+}
+
+static void propose(ParallelSolver *solver, size_t chunk)
+{
+    Maze *maze = solver -> maze;
+    size_t end_cell = maze_index(maze, maze -> end_x, maze -> end_y);
+    size_t first, last, target;
+    chunk_heads(solver, chunk, &first, &last);
+
+    for (size_t head = first; head < last; head++)
+    {
+        Tree *node = solver -> frontier -> heads[head];
+        solver -> won_moves[head] = 0;
+        for (size_t move = 0; move < MAX_MOVES; move++)
+        {
+            // END can be entered by everyone, it isn't claimed.
+            if (!target_cell(maze, node, move, &target) || target == end_cell)
+            {
+                continue;
+            }
+
+            uint8_t expected = EMPTY;
+            if (__atomic_compare_exchange_n(&maze -> types[target],
+                        &expected, CLAIMED, false,
+                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                continue;
+            }
+
+            if (expected == CLAIMED || expected == CONTESTED)
+            {
+                __atomic_store_n(&maze -> types[target], CONTESTED,
+                        __ATOMIC_RELAXED);
+                __atomic_store_n(&solver -> contested, true,
+                        __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+static void contest(ParallelSolver *solver, size_t chunk)
+{
+    Maze *maze = solver -> maze;
+    uint32_t *conflicts =
+        solver -> conflicts + chunk * PARALLEL_CHUNK_HEADS * MAX_MOVES;
+    size_t first, last, target;
+    chunk_heads(solver, chunk, &first, &last);
+
+    solver -> conflicts_count[chunk] = 0;
+    for (size_t head = first; head < last; head++)
+    {
+        Tree *node = solver -> frontier -> heads[head];
+        for (size_t move = 0; move < MAX_MOVES; move++)
+        {
+            if (target_cell(maze, node, move, &target) &&
+                __atomic_load_n(&maze -> types[target], __ATOMIC_RELAXED) ==
+                    CONTESTED)
+            {
+                conflicts[solver -> conflicts_count[chunk]++] =
+                    (head - first) * MAX_MOVES + move;
+            }
+        }
+    }
+}
+
+// Single threaded, the first head in frontier order gets the cell.
+static void resolve_contests(ParallelSolver *solver)
+{
+    Maze *maze = solver -> maze;
+    size_t target;
+    for (size_t chunk = 0; chunk < solver -> chunks; chunk++)
+    {
+        uint32_t *conflicts =
+            solver -> conflicts + chunk * PARALLEL_CHUNK_HEADS * MAX_MOVES;
+
+        for (size_t conflict = 0; conflict < solver -> conflicts_count[chunk];
+                conflict++)
+        {
+            size_t head = chunk * PARALLEL_CHUNK_HEADS +
+                            conflicts[conflict] / MAX_MOVES;
+            size_t move = conflicts[conflict] % MAX_MOVES;
+
+            if (target_cell(maze, solver -> frontier -> heads[head], move,
+                        &target) &&
+                maze -> types[target] == CONTESTED)
+            {
+                maze -> types[target] = LIVE_HEAD;
+                solver -> won_moves[head] |= 1 << move;
+            }
+        }
+    }
+}
+
+// Same as move_node() but only onto the cells this head won.
+static void expand(ParallelSolver *solver, int32_t worker, size_t chunk)
+{
+    Maze *maze = solver -> maze;
+    size_t end_cell = maze_index(maze, maze -> end_x, maze -> end_y);
+    Tree **children =
+        solver -> children + chunk * PARALLEL_CHUNK_HEADS * MAX_MOVES;
+    size_t first, last, target;
+    chunk_heads(solver, chunk, &first, &last);
+
+    solver -> children_count[chunk] = 0;
+    solver -> last_end_head[chunk] = -1;
+    solver -> moved[chunk] = false;
+    for (size_t head = first; head < last; head++)
+    {
+        Tree *node = solver -> frontier -> heads[head];
+        size_t head_cell = maze_index(maze, node -> head_x, node -> head_y);
+        bool end_reached = false;
+
+        __atomic_store_n(&maze -> types[head_cell], DEAD_HEAD,
+                __ATOMIC_RELAXED);
+
+        for (size_t move = 0; move < MAX_MOVES; move++)
+        {
+            if (!target_cell(maze, node, move, &target) ||
+                !(target == end_cell ||
+                  (solver -> won_moves[head] & 1 << move) ||
+                  __atomic_load_n(&maze -> types[target], __ATOMIC_RELAXED) ==
+                    CLAIMED))
+            {
+                continue;
+            }
+
+            Tree *child = create_node(&solver -> arenas[worker]);
+            if (child == NULL)
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            child -> parent_move = moves[move];
+            child -> head_x = maze_index_x(maze, target);
+            child -> head_y = maze_index_y(maze, target);
+            child -> parent = node;
+            child -> parent_index = node -> children_count;
+            child -> distance_runned = node -> distance_runned + 1;
+            node -> children[node -> children_count++] = child;
+            children[solver -> children_count[chunk]++] = child;
+
+            __atomic_store_n(&maze -> types[head_cell], BODY,
+                    __ATOMIC_RELAXED);
+            __atomic_store_n(&maze -> types[target], LIVE_HEAD,
+                    __ATOMIC_RELAXED);
+
+            // Several heads can enter END at once, all with the same distance.
+            __atomic_store_n(&maze -> distances_runned[target],
+                    (uint32_t)(child -> distance_runned > UINT32_MAX ?
+                        UINT32_MAX : child -> distance_runned),
+                    __ATOMIC_RELAXED);
+
+            if (target == end_cell)
+            {
+                end_reached = true;
+            }
+        }
+
+        if (end_reached)
+        {
+            solver -> last_end_head[chunk] = head;
+        }
+
+        else if (node -> children_count > 0)
+        {
+            solver -> moved[chunk] = true;
+        }
+    }
+}
+
+// Cell reached from node through moves[move], false if it's out of bounds.
+static bool target_cell(
+        const Maze *maze, const Tree *node,
+        size_t move, size_t *target)
+{
+    int32_t x = node -> head_x;
+    int32_t y = node -> head_y;
+    if ((moves[move] == LEFT && x <= 0) ||
+        (moves[move] == RIGHT && x >= maze -> columns - 1) ||
+        (moves[move] == UP && y <= 0) ||
+        (moves[move] == DOWN && y >= maze -> rows - 1))
+    {
+        return false;
+    }
+
+    x += moves[move] == LEFT ? -1 : moves[move] == RIGHT ? 1 : 0;
+    y += moves[move] == UP ? -1 : moves[move] == DOWN ? 1 : 0;
+    *target = maze_index(maze, x, y);
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef PARALLEL_SOLVER_H
+#define PARALLEL_SOLVER_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include <pthread.h>    // pthread_t and pthread_barrier_t.
+#include "arena.h"      // Arena, bump allocator for the nodes of the tree.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // Tree, Frontier and tree forking solver.
+
+// Heads of the frontier handed to a worker at once.
+#define PARALLEL_CHUNK_HEADS 256
+
+// Smaller frontiers aren't worth waking the workers, forking_step() moves them.
+#define PARALLEL_MIN_HEADS (2 * PARALLEL_CHUNK_HEADS)
+
+enum PARALLEL_PHASES {PHASE_PROPOSE, PHASE_CONTEST, PHASE_EXPAND, PHASE_QUIT};
+
+typedef struct ParallelWorker
+{
+    struct ParallelSolver *solver;
+    int32_t id;
+} ParallelWorker;
+
+// Pool of threads that moves a generation of the frontier, the thread that
+// calls parallel_solver_step() is worker 0.
+// Chunks of the frontier are split evenly between the workers, a worker that
+// runs out of chunks steals them from the end of the others' ranges.
+typedef struct ParallelSolver
+{
+    int32_t threads;
+    pthread_t *threads_ids;         // threads - 1, worker 0 isn't created.
+    ParallelWorker *workers;
+    pthread_barrier_t phase_start;
+    pthread_barrier_t phase_done;
+    enum PARALLEL_PHASES phase;
+    bool contested;                 // Two heads proposed the same cell.
+    Arena *arenas;                  // One per worker for the new nodes.
+    uint64_t *ranges;               // Chunks left per worker: begin << 32 |
+                                    // end, taken with compare and swap.
+
+    // Generation being moved, everything per chunk is in frontier order.
+    Frontier *frontier;
+    Maze *maze;
+    size_t chunks;
+    size_t chunks_capacity;
+    Tree **children;                // MAX_MOVES * PARALLEL_CHUNK_HEADS each.
+    size_t *children_count;
+    uint32_t *conflicts;            // head offset * MAX_MOVES + move, same
+    size_t *conflicts_count;        // size as children.
+    int64_t *last_end_head;         // Last head that reached END or -1.
+    bool *moved;
+    uint8_t *won_moves;             // Per head, bit per move won on contest.
+} ParallelSolver;
+
+bool parallel_solver_init(ParallelSolver *solver, int32_t threads);
+bool parallel_solver_step(
+        ParallelSolver *solver,
+        Frontier *frontier, Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node);
+
+void parallel_solver_free(ParallelSolver *solver);
+
+#endif // PARALLEL_SOLVER_H
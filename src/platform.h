@@ -0,0 +1,38 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// Small wrappers over POSIX shared by the programs, whoever includes this
+// must define _POSIX_C_SOURCE before any other include.
+
+#include <time.h>       // clock_gettime() and CLOCK_MONOTONIC.
+#include <unistd.h>     // sysconf for the physical memory and the cores.
+
+// Monotonic wall-clock time in miliseconds, only differences are meaningful.
+static inline double get_time_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+// Physical memory of the machine in bytes, 0 if it can't be known.
+static inline double available_memory(void)
+{
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || page_size <= 0)
+    {
+        return 0;
+    }
+
+    return (double)pages * page_size;
+}
+
+// Cores online, at least 1.
+static inline int available_cores(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? cores : 1;
+}
+
+#endif // PLATFORM_H
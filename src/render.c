@@ -0,0 +1,958 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc and free.
+#include <string.h>     // memcpy.
+#include <math.h>       // fmin, fmax and floor.
+#include "render.h"
+
+// How much a cell matters on the mipmap, a texel keeps the color of its cell
+// with the highest rank. Empty cells go over walls, so the unsolved parts of
+// the maze look empty and the solved ones show their color.
+enum RANKS
+{
+    RANK_WALL,
+    RANK_EMPTY,
+    RANK_BODY,
+    RANK_DEAD_HEAD,
+    RANK_WIN_BLOCK,
+    RANK_LIVE_HEAD,
+    RANK_ENDS,
+};
+
+static uint8_t cell_rank(const Display *display, const Maze *maze, size_t cell);
+static SDL_Rect update_mipmap(
+        Display *display, const Maze *maze,
+        const DirtyCells *dirty, int32_t level);
+
+static bool downsample(
+        Mipmap *mipmap, const Display *display, const Maze *maze,
+        int32_t level, int32_t x, int32_t y);
+
+static void place_view(
+        Display *display, const Maze *maze,
+        int32_t window_width, int32_t window_height,
+        int64_t *origin_x, int64_t *origin_y);
+
+static bool visible_range(
+        int64_t origin, int32_t length, int32_t texel_pixels, int32_t count,
+        int32_t *first, int32_t *last);
+
+static void draw_screen(
+        Display *display, const Maze *maze, const DirtyCells *dirty,
+        SDL_Rect changed, int32_t window_width, int32_t window_height,
+        int64_t origin_x, int64_t origin_y);
+
+static bool resize_screen(Display *display, int32_t width, int32_t height);
+static SDL_Rect update_screen(
+        Display *display, const Maze *maze, const DirtyCells *dirty,
+        SDL_Rect changed, int64_t origin_x, int64_t origin_y);
+
+static void compose_screen(
+        Display *display, const Maze *maze, SDL_Rect area,
+        int64_t origin_x, int64_t origin_y);
+
+static int64_t floor_div(int64_t a, int64_t b);
+
+// Draws the maze and clears dirty, with the texture renderer only the dirty
+// cells are recomputed. The caller presents it, so overlays can go on top.
+// Only the cells on the view are drawn, zoomed out that's a level of the
+// mipmap, so a frame costs the pixels of the window and not the whole maze.
+void draw_maze(Display *display, const Maze *maze, DirtyCells *dirty)
+{
+    int32_t window_width, window_height;
+    SDL_GetWindowSize(display -> window, &window_width, &window_height);
+    SDL_SetRenderDrawColor(display -> renderer, 0, 0, 0, 1);
+    SDL_RenderClear(display -> renderer);
+
+    int64_t origin_x, origin_y;
+    place_view(display, maze, window_width, window_height,
+            &origin_x, &origin_y);
+
+    int32_t zoom = display -> view.zoom;
+    SDL_Rect changed = update_mipmap(display, maze, dirty,
+            zoom < 0 ? -zoom : 0);
+
+    if (display -> texture != NULL)
+    {
+        update_pixels(display, maze, dirty);
+    }
+
+    if (display -> mipmap.count > 0 && (zoom < 0 || display -> texture == NULL))
+    {
+        draw_screen(display, maze, dirty, changed,
+                window_width, window_height, origin_x, origin_y);
+
+        dirty_clear(dirty);
+        return;
+    }
+
+    int32_t first_x, first_y, last_x, last_y;
+    if (!visible_range(origin_x, window_width, zoom, maze -> columns,
+                &first_x, &last_x) ||
+            !visible_range(origin_y, window_height, zoom, maze -> rows,
+                &first_y, &last_y))
+    {
+        dirty_clear(dirty);
+        return;
+    }
+
+    if (display -> texture != NULL)
+    {
+        SDL_Rect source =
+        {
+            .x = first_x,
+            .y = first_y,
+            .w = last_x - first_x + 1,
+            .h = last_y - first_y + 1,
+        };
+
+        SDL_Rect destination =
+        {
+            .x = first_x * zoom - origin_x,
+            .y = first_y * zoom - origin_y,
+            .w = source.w * zoom,
+            .h = source.h * zoom,
+        };
+
+        SDL_RenderCopy(display -> renderer, display -> texture,
+                &source, &destination);
+
+        dirty_clear(dirty);
+        return;
+    }
+
+    SDL_Rect square =
+    {
+        .x = first_x * zoom - origin_x,
+        .y = first_y * zoom - origin_y,
+        .w = zoom,
+        .h = zoom,
+    };
+
+    uint32_t color;
+    for (int32_t row = first_y; row <= last_y; row++)
+    {
+        size_t cell = maze_index(maze, first_x, row);
+        for (int32_t column = first_x; column <= last_x; column++, cell++)
+        {
+            color = cell_color(display, maze, cell);
+            SDL_SetRenderDrawColor(display -> renderer,
+                    (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF,
+                    255);
+
+            SDL_RenderFillRect(display -> renderer, &square);
+            square.x += square.w;
+        }
+        square.x = first_x * zoom - origin_x;
+        square.y += square.h;
+    }
+
+    dirty_clear(dirty);
+}
+
+// Draws the maze fitted on width x height pixels without SDL, for exports,
+// and clears dirty. Like the screen of draw_maze() only the pixels of the
+// changed cells are composed, the whole frame is then copied to pixels.
+bool draw_offscreen(
+        Display *display, const Maze *maze, DirtyCells *dirty,
+        uint32_t *pixels, int32_t width, int32_t height)
+{
+    if (!resize_screen(display, width, height))
+    {
+        perror("Failed to allocate memory for frame\n");
+        return false;
+    }
+
+    int64_t origin_x, origin_y;
+    display -> view.manual = false;
+    place_view(display, maze, width, height, &origin_x, &origin_y);
+
+    int32_t zoom = display -> view.zoom;
+    SDL_Rect changed = update_mipmap(display, maze, dirty,
+            zoom < 0 ? -zoom : 0);
+
+    update_screen(display, maze, dirty, changed, origin_x, origin_y);
+    memcpy(pixels, display -> screen_pixels,
+            sizeof(uint32_t) * (size_t)width * height);
+
+    dirty_clear(dirty);
+    return true;
+}
+
+// Recomputes the dirty cells on the copy of the texture and uploads only the
+// rectangle that encloses them.
+void update_pixels(
+        Display *display, const Maze *maze,
+        const DirtyCells *dirty)
+{
+    int pitch = maze -> columns * sizeof(uint32_t);
+    if (dirty -> everything)
+    {
+        fill_pixels(display, maze, display -> pixels, pitch);
+        SDL_UpdateTexture(display -> texture, NULL, display -> pixels, pitch);
+        return;
+    }
+
+    if (dirty -> count == 0)
+    {
+        return;
+    }
+
+    int32_t min_x = maze -> columns, min_y = maze -> rows;
+    int32_t max_x = -1, max_y = -1;
+    for (size_t dirty_cell = 0; dirty_cell < dirty -> count; dirty_cell++)
+    {
+        size_t cell = dirty -> cells[dirty_cell];
+        int32_t x = maze_index_x(maze, cell);
+        int32_t y = maze_index_y(maze, cell);
+
+        display -> pixels[cell] = cell_color(display, maze, cell);
+        min_x = x < min_x ? x : min_x;
+        min_y = y < min_y ? y : min_y;
+        max_x = x > max_x ? x : max_x;
+        max_y = y > max_y ? y : max_y;
+    }
+
+    SDL_Rect area =
+    {
+        .x = min_x,
+        .y = min_y,
+        .w = max_x - min_x + 1,
+        .h = max_y - min_y + 1,
+    };
+
+    SDL_UpdateTexture(display -> texture, &area,
+            display -> pixels + maze_index(maze, min_x, min_y), pitch);
+}
+
+// Color of a cell packed as ARGB8888, same layout as the texture.
+uint32_t cell_color(const Display *display, const Maze *maze, size_t cell)
+{
+    const Gradient *gradient = &display -> gradient;
+    int r, g, b;
+
+    r = 255, g = 255, b = 255;
+    if (maze -> types[cell] == EMPTY)
+    {
+        r = 255, g = 255, b = 255;
+    }
+
+    // START of maze
+    else if (cell == maze_index(maze, maze -> start_x, maze -> start_y))
+    {
+        r = 255, g = 127, b = 127;
+    }
+    
+    // END of maze
+    else if (cell == maze_index(maze, maze -> end_x, maze -> end_y))
+    {
+        r = 255, g = 0, b = 0;
+    }
+
+    else if (maze -> types[cell] == WALL)
+    {
+        r = 0, g = 0, b = 0;
+    }
+
+    else if (maze -> types[cell] == LIVE_HEAD ||
+            maze -> types[cell] == END_LIVE_HEAD)
+    {
+        r = 255, g = 128, b = 255;
+    }
+
+    else if ((maze -> types[cell] == DEAD_HEAD ||
+                maze -> types[cell] == END_DEAD_HEAD) &&
+            display -> show_dead_head)
+    {
+        r = 255, g = 0, b = 255;
+    }
+
+    else if (maze -> types[cell] == WIN_BLOCK)
+    {
+        r = 255, g = 255, b = 0;
+    }
+
+    else if(display -> show_body)
+    {
+        int64_t distance = maze -> distances_runned[cell];
+        if (distance >= gradient -> span && !gradient -> cyclic)
+        {
+            return gradient -> overflow;
+        }
+
+        distance %= gradient -> span;
+        if (gradient -> span > (int64_t)gradient -> size)
+        {
+            distance = distance * gradient -> size / gradient -> span;
+        }
+
+        return gradient -> colors[distance];
+    }
+
+    else // No body show aka equal to EMPTY square.
+    {
+        r = 255, g = 255, b = 255;
+    }
+
+    return 0xFF000000u | (uint32_t)r << 16 | (uint32_t)g << 8 | (uint32_t)b;
+}
+
+// Writes one ARGB8888 pixel per cell, pitch is the bytes between rows.
+void fill_pixels(
+        const Display *display, const Maze *maze,
+        uint32_t *pixels, int pitch)
+{
+    size_t cell = 0;
+    for (int32_t row = 0; row < maze -> rows; row++)
+    {
+        uint32_t *pixel = (uint32_t *)((uint8_t *)pixels + (size_t)row * pitch);
+        for (int32_t column = 0; column < maze -> columns; column++, cell++)
+        {
+            pixel[column] = cell_color(display, maze, cell);
+        }
+    }
+}
+
+static uint32_t hsl_to_argb(double hue, double saturation, double lightness)
+{
+    int r, g, b;
+    hsl_to_rgb(hue, saturation, lightness, &r, &g, &b);
+    return 0xFF000000u | (uint32_t)r << 16 | (uint32_t)g << 8 | (uint32_t)b;
+}
+
+// The color of every distance is computed here once, instead of on each frame
+// for each body cell.
+bool gradient_init(
+        Gradient *gradient, enum GRADIENTS name,
+        const Maze *maze)
+{
+    // The distance between the start node and end node can be actually bigger
+    // or smaller due to 'S' shaped mazes, I decided it that using this number
+    // for coloring the distance runned by a node is good.
+    int64_t max_distance_runned = maze_cells(maze) / 5;
+    if (max_distance_runned < 1)
+    {
+        max_distance_runned = 1;
+    }
+
+    gradient -> cyclic = false;
+    gradient -> overflow = hsl_to_argb(120, 1.0, 0.5);
+    if (name == GRADIENT_GREEN)
+    {
+        // Saturation goes from 0.2 to 1.0, then it stays on plain green.
+        // The loops only fix the rounding of the last distance on the ramp.
+        int64_t last = 0.8 * max_distance_runned;
+        while (0.2 + (last + 1) / (double)max_distance_runned <= 1.0)
+        {
+            last++;
+        }
+
+        while (0.2 + last / (double)max_distance_runned > 1.0)
+        {
+            last--;
+        }
+
+        gradient -> span = last + 1;
+    }
+
+    else if (name == GRADIENT_RAINBOW)
+    {
+        gradient -> span = max_distance_runned;
+        gradient -> overflow = hsl_to_argb(300, 1.0, 0.5);
+    }
+
+    else
+    {
+        gradient -> span = GRADIENT_CYCLE_LENGTH;
+        gradient -> cyclic = true;
+    }
+
+    gradient -> size = gradient -> span < GRADIENT_MAX_COLORS ?
+                            gradient -> span : GRADIENT_MAX_COLORS;
+
+    gradient -> colors = malloc(sizeof(uint32_t) * gradient -> size);
+    if (gradient -> colors == NULL)
+    {
+        perror("Failed to allocate memory for gradient\n");
+        return false;
+    }
+
+    for (size_t color = 0; color < gradient -> size; color++)
+    {
+        // First distance that falls on this color.
+        int64_t distance = color * gradient -> span / gradient -> size;
+        if (name == GRADIENT_GREEN)
+        {
+            gradient -> colors[color] = hsl_to_argb(120,
+                    0.2 + distance / (double)max_distance_runned, 0.5);
+        }
+
+        else
+        {
+            gradient -> colors[color] = hsl_to_argb(
+                    300.0 * distance / gradient -> span, 1.0, 0.5);
+        }
+    }
+
+    return true;
+}
+
+void gradient_free(Gradient *gradient)
+{
+    free(gradient -> colors);
+    gradient -> colors = NULL;
+    gradient -> size = 0;
+}
+
+// Texture with a texel per cell, it fails if the maze is bigger than the
+// biggest texture the renderer can create.
+// The texture content isn't kept by SDL between frames, so a copy of it is
+// kept on pixels.
+bool create_texture(Display *display, const Maze *maze)
+{
+    display -> texture = SDL_CreateTexture(display -> renderer,
+            SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+            maze -> columns, maze -> rows);
+
+    if (display -> texture == NULL)
+    {
+        SDL_Log("SDL_CreateTexture failed (%s)", SDL_GetError());
+        return false;
+    }
+
+    display -> pixels = malloc(sizeof(uint32_t) * maze_cells(maze));
+    if (display -> pixels == NULL)
+    {
+        SDL_Log("Failed to allocate memory for pixels");
+        SDL_DestroyTexture(display -> texture);
+        display -> texture = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+// Allocates the levels of the mipmap, they're filled by the first draw_maze().
+bool mipmap_init(Mipmap *mipmap, const Maze *maze)
+{
+    *mipmap = (Mipmap){0};
+    mipmap -> levels[0].columns = maze -> columns;
+    mipmap -> levels[0].rows = maze -> rows;
+    mipmap -> count = 1;
+
+    MipmapLevel *last = &mipmap -> levels[0];
+    while (mipmap -> count < MIPMAP_MAX_LEVELS &&
+            (last -> columns > 1 || last -> rows > 1))
+    {
+        MipmapLevel *level = &mipmap -> levels[mipmap -> count++];
+        level -> columns = (last -> columns + 1) / 2;
+        level -> rows = (last -> rows + 1) / 2;
+
+        size_t texels = (size_t)level -> columns * level -> rows;
+        level -> colors = malloc(sizeof(uint32_t) * texels);
+        level -> ranks = malloc(sizeof(uint8_t) * texels);
+        if (level -> colors == NULL || level -> ranks == NULL)
+        {
+            perror("Failed to allocate memory for mipmap\n");
+            mipmap_free(mipmap);
+            return false;
+        }
+
+        last = level;
+    }
+
+    return true;
+}
+
+// Bytes mipmap_init() allocates for a maze of rows x columns, about a third
+// of a texel and a rank per cell.
+double mipmap_memory(int32_t rows, int32_t columns)
+{
+    double bytes = 0;
+    for (int32_t level = 1; level < MIPMAP_MAX_LEVELS &&
+            (columns > 1 || rows > 1); level++)
+    {
+        columns = (columns + 1) / 2;
+        rows = (rows + 1) / 2;
+        bytes += (double)columns * rows * (sizeof(uint32_t) + sizeof(uint8_t));
+    }
+
+    return bytes;
+}
+
+void mipmap_free(Mipmap *mipmap)
+{
+    for (int32_t level = 1; level < mipmap -> count; level++)
+    {
+        free(mipmap -> levels[level].colors);
+        free(mipmap -> levels[level].ranks);
+    }
+
+    *mipmap = (Mipmap){0};
+}
+
+// Everything but the window, the renderer and the gradient.
+void display_free(Display *display)
+{
+    if (display -> texture != NULL)
+    {
+        SDL_DestroyTexture(display -> texture);
+    }
+
+    if (display -> screen != NULL)
+    {
+        SDL_DestroyTexture(display -> screen);
+    }
+
+    free(display -> pixels);
+    free(display -> screen_pixels);
+    mipmap_free(&display -> mipmap);
+    display -> texture = display -> screen = NULL;
+    display -> pixels = display -> screen_pixels = NULL;
+    display -> screen_valid = false;
+}
+
+// Moves the view VIEWPORT_PAN_PIXELS per step, in cells of the current zoom.
+void viewport_pan(Viewport *view, int32_t steps_x, int32_t steps_y)
+{
+    double cells = view -> zoom > 0 ?
+        (double)VIEWPORT_PAN_PIXELS / view -> zoom :
+        (double)VIEWPORT_PAN_PIXELS * ((int64_t)1 << -view -> zoom);
+
+    view -> center_x += steps_x * cells;
+    view -> center_y += steps_y * cells;
+    view -> manual = true;
+    view -> changed = true;
+}
+
+// Each step in doubles the pixels of a cell and each step out halves them,
+// under a pixel per cell it goes up the levels of the mipmap. draw_maze()
+// clamps it to what the maze has.
+void viewport_zoom(Viewport *view, int32_t steps)
+{
+    int32_t zoom = view -> zoom == 0 ? 1 : view -> zoom;
+    for (; steps > 0; steps--)
+    {
+        zoom = zoom < -1 ? zoom + 1 : zoom == -1 ? 1 : zoom * 2;
+        zoom = zoom > VIEWPORT_MAX_ZOOM ? VIEWPORT_MAX_ZOOM : zoom;
+    }
+
+    for (; steps < 0; steps++)
+    {
+        zoom = zoom > 1 ? zoom / 2 : zoom == 1 ? -1 : zoom - 1;
+        zoom = zoom < -MIPMAP_MAX_LEVELS ? -MIPMAP_MAX_LEVELS : zoom;
+    }
+
+    view -> zoom = zoom;
+    view -> manual = true;
+    view -> changed = true;
+}
+
+void viewport_fit(Viewport *view)
+{
+    view -> manual = false;
+    view -> changed = true;
+}
+
+// Fits the maze on the window until the view is manual, then clamps it to
+// the maze. origin is the pixel, counted from the first texel of the level
+// drawn, that goes on the top left corner of the window.
+static void place_view(
+        Display *display, const Maze *maze,
+        int32_t window_width, int32_t window_height,
+        int64_t *origin_x, int64_t *origin_y)
+{
+    Viewport *view = &display -> view;
+    const Mipmap *mipmap = &display -> mipmap;
+    int32_t min_zoom = mipmap -> count > 1 ? -(mipmap -> count - 1) : 1;
+
+    if (!view -> manual)
+    {
+        // The biggest cells that fit, or the first level that does.
+        view -> zoom = fmin(window_width / maze -> columns,
+                            window_height / maze -> rows);
+
+        for (int32_t level = 1; view -> zoom == 0 && level < mipmap -> count;
+                level++)
+        {
+            if (mipmap -> levels[level].columns <= window_width &&
+                    mipmap -> levels[level].rows <= window_height)
+            {
+                view -> zoom = -level;
+            }
+        }
+
+        view -> zoom = view -> zoom == 0 ? min_zoom : view -> zoom;
+        view -> center_x = maze -> columns / 2.0;
+        view -> center_y = maze -> rows / 2.0;
+    }
+
+    view -> zoom = view -> zoom < min_zoom ? min_zoom : view -> zoom;
+    view -> zoom = view -> zoom == 0 ? 1 : view -> zoom;
+    view -> center_x = fmax(0, fmin(view -> center_x, maze -> columns));
+    view -> center_y = fmax(0, fmin(view -> center_y, maze -> rows));
+    view -> changed = false;
+
+    int32_t level = view -> zoom < 0 ? -view -> zoom : 0;
+    int32_t texel_pixels = view -> zoom > 0 ? view -> zoom : 1;
+    int32_t columns = level > 0 ? mipmap -> levels[level].columns :
+        maze -> columns;
+    int32_t rows = level > 0 ? mipmap -> levels[level].rows : maze -> rows;
+
+    if (!view -> manual)
+    {
+        // Same padding on both sides.
+        *origin_x = -(window_width - (int64_t)columns * texel_pixels) / 2;
+        *origin_y = -(window_height - (int64_t)rows * texel_pixels) / 2;
+        return;
+    }
+
+    double texels = (double)((int64_t)1 << level) / texel_pixels;
+    *origin_x = (int64_t)floor(view -> center_x / texels) - window_width / 2;
+    *origin_y = (int64_t)floor(view -> center_y / texels) - window_height / 2;
+}
+
+// Texels [first, last] of count that fall on the window, false if none.
+static bool visible_range(
+        int64_t origin, int32_t length, int32_t texel_pixels, int32_t count,
+        int32_t *first, int32_t *last)
+{
+    int64_t from = floor_div(origin, texel_pixels);
+    int64_t to = floor_div(origin + length - 1, texel_pixels);
+    *first = from < 0 ? 0 : from;
+    *last = to >= count ? count - 1 : to;
+    return *first <= *last;
+}
+
+// Rebuilds the mipmap if everything changed, otherwise every dirty cell is
+// carried up the levels until a texel doesn't change. Returns the texels of
+// level that changed, empty if none or if everything did.
+static SDL_Rect update_mipmap(
+        Display *display, const Maze *maze,
+        const DirtyCells *dirty, int32_t level)
+{
+    Mipmap *mipmap = &display -> mipmap;
+    SDL_Rect changed = {0};
+    if (mipmap -> count == 0)
+    {
+        return changed;
+    }
+
+    if (dirty -> everything || !mipmap -> built)
+    {
+        for (int32_t k = 1; k < mipmap -> count; k++)
+        {
+            for (int32_t y = 0; y < mipmap -> levels[k].rows; y++)
+            {
+                for (int32_t x = 0; x < mipmap -> levels[k].columns; x++)
+                {
+                    downsample(mipmap, display, maze, k, x, y);
+                }
+            }
+        }
+
+        mipmap -> built = true;
+        return changed;
+    }
+
+    int32_t min_x = INT32_MAX, min_y = INT32_MAX;
+    int32_t max_x = -1, max_y = -1;
+    for (size_t dirty_cell = 0; dirty_cell < dirty -> count; dirty_cell++)
+    {
+        size_t cell = dirty -> cells[dirty_cell];
+        int32_t x = maze_index_x(maze, cell);
+        int32_t y = maze_index_y(maze, cell);
+        int32_t k = 1;
+        for (; k < mipmap -> count; k++)
+        {
+            if (!downsample(mipmap, display, maze, k, x >> k, y >> k))
+            {
+                break;
+            }
+        }
+
+        // Levels [0, k) got a new texel.
+        if (level < k)
+        {
+            min_x = x >> level < min_x ? x >> level : min_x;
+            min_y = y >> level < min_y ? y >> level : min_y;
+            max_x = x >> level > max_x ? x >> level : max_x;
+            max_y = y >> level > max_y ? y >> level : max_y;
+        }
+    }
+
+    if (max_x >= 0)
+    {
+        changed = (SDL_Rect){
+            .x = min_x,
+            .y = min_y,
+            .w = max_x - min_x + 1,
+            .h = max_y - min_y + 1,
+        };
+    }
+
+    return changed;
+}
+
+// Recomputes texel (x, y) of level from the 4 below it, true if it changed.
+static bool downsample(
+        Mipmap *mipmap, const Display *display, const Maze *maze,
+        int32_t level, int32_t x, int32_t y)
+{
+    const MipmapLevel *below = &mipmap -> levels[level - 1];
+    MipmapLevel *texels = &mipmap -> levels[level];
+    uint32_t color = 0;
+    int32_t rank = -1;
+
+    for (int32_t child_y = 2 * y; child_y < 2 * y + 2; child_y++)
+    {
+        for (int32_t child_x = 2 * x; child_x < 2 * x + 2; child_x++)
+        {
+            if (child_x >= below -> columns || child_y >= below -> rows)
+            {
+                continue;
+            }
+
+            int32_t child_rank;
+            uint32_t child_color;
+            if (level == 1)
+            {
+                size_t cell = maze_index(maze, child_x, child_y);
+                child_rank = cell_rank(display, maze, cell);
+                child_color = cell_color(display, maze, cell);
+            }
+
+            else
+            {
+                size_t texel = (size_t)child_y * below -> columns + child_x;
+                child_rank = below -> ranks[texel];
+                child_color = below -> colors[texel];
+            }
+
+            if (child_rank > rank)
+            {
+                rank = child_rank;
+                color = child_color;
+            }
+        }
+    }
+
+    size_t texel = (size_t)y * texels -> columns + x;
+    bool changed = !mipmap -> built || texels -> ranks[texel] != rank ||
+        texels -> colors[texel] != color;
+
+    texels -> ranks[texel] = rank;
+    texels -> colors[texel] = color;
+    return changed;
+}
+
+// Same cases as cell_color(), so a texel shows the color of one of its cells.
+static uint8_t cell_rank(const Display *display, const Maze *maze, size_t cell)
+{
+    uint8_t type = maze -> types[cell];
+    if (type == EMPTY)
+    {
+        return RANK_EMPTY;
+    }
+
+    else if (cell == maze_index(maze, maze -> start_x, maze -> start_y) ||
+            cell == maze_index(maze, maze -> end_x, maze -> end_y))
+    {
+        return RANK_ENDS;
+    }
+
+    else if (type == WALL)
+    {
+        return RANK_WALL;
+    }
+
+    else if (type == LIVE_HEAD || type == END_LIVE_HEAD)
+    {
+        return RANK_LIVE_HEAD;
+    }
+
+    else if ((type == DEAD_HEAD || type == END_DEAD_HEAD) &&
+            display -> show_dead_head)
+    {
+        return RANK_DEAD_HEAD;
+    }
+
+    else if (type == WIN_BLOCK)
+    {
+        return RANK_WIN_BLOCK;
+    }
+
+    return display -> show_body ? RANK_BODY : RANK_EMPTY;
+}
+
+// Draws the level of the view through the window sized screen texture.
+static void draw_screen(
+        Display *display, const Maze *maze, const DirtyCells *dirty,
+        SDL_Rect changed, int32_t window_width, int32_t window_height,
+        int64_t origin_x, int64_t origin_y)
+{
+    if (!resize_screen(display, window_width, window_height))
+    {
+        // Without it the mipmap can't be drawn, so zooming out stops.
+        SDL_Log("Failed to create the screen texture (%s)", SDL_GetError());
+        mipmap_free(&display -> mipmap);
+        return;
+    }
+
+    SDL_Rect area = update_screen(display, maze, dirty, changed,
+            origin_x, origin_y);
+
+    if (area.w > 0 && area.h > 0)
+    {
+        SDL_UpdateTexture(display -> screen, &area,
+                display -> screen_pixels +
+                    (size_t)area.y * window_width + area.x,
+                window_width * sizeof(uint32_t));
+    }
+
+    SDL_RenderCopy(display -> renderer, display -> screen, NULL, NULL);
+}
+
+// screen_pixels of width x height, plus the screen texture if there's a
+// renderer. Nothing is done if they already have that size.
+static bool resize_screen(Display *display, int32_t width, int32_t height)
+{
+    if (display -> screen_pixels != NULL && display -> screen_width == width &&
+            display -> screen_height == height)
+    {
+        return true;
+    }
+
+    if (display -> screen != NULL)
+    {
+        SDL_DestroyTexture(display -> screen);
+        display -> screen = NULL;
+    }
+
+    free(display -> screen_pixels);
+    display -> screen_valid = false;
+    display -> screen_width = width;
+    display -> screen_height = height;
+    display -> screen_pixels = malloc(sizeof(uint32_t) *
+            (size_t)width * height);
+
+    if (display -> screen_pixels != NULL && display -> renderer != NULL)
+    {
+        display -> screen = SDL_CreateTexture(display -> renderer,
+                SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                width, height);
+    }
+
+    if (display -> screen_pixels == NULL ||
+            (display -> renderer != NULL && display -> screen == NULL))
+    {
+        free(display -> screen_pixels);
+        display -> screen_pixels = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+// Composes screen_pixels again if the view moved, otherwise only the pixels
+// of the changed texels. Returns the area composed.
+static SDL_Rect update_screen(
+        Display *display, const Maze *maze, const DirtyCells *dirty,
+        SDL_Rect changed, int64_t origin_x, int64_t origin_y)
+{
+    int32_t zoom = display -> view.zoom;
+    int32_t texel_pixels = zoom > 0 ? zoom : 1;
+    int32_t width = display -> screen_width;
+    int32_t height = display -> screen_height;
+    SDL_Rect area = {0, 0, width, height};
+
+    if (display -> screen_valid && !dirty -> everything &&
+            display -> screen_zoom == zoom &&
+            display -> screen_x == origin_x && display -> screen_y == origin_y)
+    {
+        // Pixels of the changed texels, clipped to the screen.
+        int64_t from_x = (int64_t)changed.x * texel_pixels - origin_x;
+        int64_t from_y = (int64_t)changed.y * texel_pixels - origin_y;
+        int64_t to_x = from_x + (int64_t)changed.w * texel_pixels;
+        int64_t to_y = from_y + (int64_t)changed.h * texel_pixels;
+        from_x = from_x < 0 ? 0 : from_x;
+        from_y = from_y < 0 ? 0 : from_y;
+        to_x = to_x > width ? width : to_x;
+        to_y = to_y > height ? height : to_y;
+        area = (SDL_Rect){from_x, from_y, to_x - from_x, to_y - from_y};
+    }
+
+    if (area.w > 0 && area.h > 0)
+    {
+        compose_screen(display, maze, area, origin_x, origin_y);
+    }
+
+    display -> screen_valid = true;
+    display -> screen_zoom = zoom;
+    display -> screen_x = origin_x;
+    display -> screen_y = origin_y;
+    return area;
+}
+
+// Writes the pixels of area from the texels of the view, black off the maze.
+static void compose_screen(
+        Display *display, const Maze *maze, SDL_Rect area,
+        int64_t origin_x, int64_t origin_y)
+{
+    int32_t zoom = display -> view.zoom;
+    int32_t level = zoom < 0 ? -zoom : 0;
+    int32_t texel_pixels = zoom > 0 ? zoom : 1;
+    const MipmapLevel *texels = &display -> mipmap.levels[level];
+
+    for (int32_t y = area.y; y < area.y + area.h; y++)
+    {
+        uint32_t *pixel = display -> screen_pixels +
+            (size_t)y * display -> screen_width;
+
+        int64_t texel_y = floor_div(y + origin_y, texel_pixels);
+        for (int32_t x = area.x; x < area.x + area.w; x++)
+        {
+            int64_t texel_x = floor_div(x + origin_x, texel_pixels);
+            if (texel_x < 0 || texel_x >= texels -> columns ||
+                    texel_y < 0 || texel_y >= texels -> rows)
+            {
+                pixel[x] = 0xFF000000u;
+            }
+
+            else if (level == 0)
+            {
+                pixel[x] = cell_color(display, maze,
+                        maze_index(maze, texel_x, texel_y));
+            }
+
+            else
+            {
+                pixel[x] = texels -> colors[
+                    (size_t)texel_y * texels -> columns + texel_x];
+            }
+        }
+    }
+}
+
+// Rounds towards minus infinity, the view can start before the maze.
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+// https://en.wikipedia.org/wiki/HSL_and_HSV#HSL_to_RGB
+// Recommendations for good rainbows
+void hsl_to_rgb(double hue, double saturation, double lightness,
+        int *r, int *g, int *b)
+{
+    double a = saturation * fmin(lightness, 1 - lightness);
+    double k = (int)(0 + hue / 30.0) % 12;
+    *r = 255 * (lightness - a * fmax(-1, fmin(fmin(k - 3, 9 - k), 1)));
+
+    k = (int)(8 + hue / 30.0) % 12;
+    *g = 255 * (lightness - a * fmax(-1, fmin(fmin(k - 3, 9 - k), 1)));
+
+    k = (int)(4 + hue / 30.0) % 12;
+    *b = 255 * (lightness - a * fmax(-1, fmin(fmin(k - 3, 9 - k), 1)));
+
+    // Multiply r, g, b by 255 because these were on [0, 1] interval.
+}
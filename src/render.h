@@ -0,0 +1,131 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include "SDL.h"        // graphics.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // DirtyCells, cells changed since the last frame.
+
+// Colors precomputed for the body, longer gradients are quantized.
+#define GRADIENT_MAX_COLORS 4096
+
+// Distances that the cycle gradient takes to go around all the hues.
+#define GRADIENT_CYCLE_LENGTH 720
+
+// Levels of the mipmap, each halves the last so 32 cover any int32_t size.
+#define MIPMAP_MAX_LEVELS 32
+
+// Pixels that a pan moves the view, and the most pixels a cell gets.
+#define VIEWPORT_PAN_PIXELS 64
+#define VIEWPORT_MAX_ZOOM 64
+
+enum RENDERERS {RENDERER_TEXTURE, RENDERER_RECTS};
+enum GRADIENTS {GRADIENT_GREEN, GRADIENT_RAINBOW, GRADIENT_CYCLE};
+
+// Body color of each distance runned, computed once per maze.
+// Distances [0, span) are spread over size colors, the ones after span wrap
+// around if cyclic or get the overflow color.
+typedef struct Gradient
+{
+    uint32_t *colors;
+    size_t size;
+    int64_t span;
+    bool cyclic;
+    uint32_t overflow;
+} Gradient;
+
+// Downsampled copies of the cell state, a texel of level k covers 2^k x 2^k
+// cells and keeps the color of the one that matters the most (heads, then the
+// winner path, then the body, ...), so thin paths don't fade out when zoomed
+// out. Level 0 is the maze itself and has no arrays.
+typedef struct MipmapLevel
+{
+    int32_t columns;
+    int32_t rows;
+    uint32_t *colors;           // ARGB8888 of each texel.
+    uint8_t *ranks;             // How much each texel matters, see cell_rank.
+} MipmapLevel;
+
+typedef struct Mipmap
+{
+    MipmapLevel levels[MIPMAP_MAX_LEVELS];
+    int32_t count;              // 0 if there's no mipmap.
+    bool built;
+} Mipmap;
+
+// Part of the maze shown on the window. A positive zoom is the pixels of a
+// cell, a negative one draws level -zoom of the mipmap at a texel per pixel.
+// Until the user pans or zooms (manual) the maze is fitted to the window.
+typedef struct Viewport
+{
+    double center_x;            // Cell on the center of the window.
+    double center_y;
+    int32_t zoom;
+    bool manual;
+    bool changed;               // Since the last draw_maze().
+} Viewport;
+
+// Everything needed to draw on the window, texture is NULL when the maze is
+// drawn with a rectangle per cell (RENDERER_RECTS).
+// Zoomed out or without texture the maze is drawn through screen, a window
+// sized texture composed from the mipmap with only the texels on the view.
+// Drawn off screen (exports) there's no window, renderer nor screen, only
+// screen_pixels.
+typedef struct Display
+{
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;       // One texel per cell.
+    uint32_t *pixels;           // Copy of the texture kept between frames.
+    Gradient gradient;
+    bool show_body;
+    bool show_dead_head;
+    Viewport view;
+    Mipmap mipmap;
+    SDL_Texture *screen;
+    uint32_t *screen_pixels;    // Copy of screen.
+    int32_t screen_width;
+    int32_t screen_height;
+    int32_t screen_zoom;        // View that screen_pixels was composed with.
+    int64_t screen_x;
+    int64_t screen_y;
+    bool screen_valid;
+} Display;
+
+void hsl_to_rgb(
+        double hue, double saturation, double lightness,
+        int *r, int *g, int *b);
+
+void draw_maze(Display *display, const Maze *maze, DirtyCells *dirty);
+bool draw_offscreen(
+        Display *display, const Maze *maze, DirtyCells *dirty,
+        uint32_t *pixels, int32_t width, int32_t height);
+
+void update_pixels(
+        Display *display, const Maze *maze,
+        const DirtyCells *dirty);
+
+uint32_t cell_color(const Display *display, const Maze *maze, size_t cell);
+void fill_pixels(
+        const Display *display, const Maze *maze,
+        uint32_t *pixels, int pitch);
+
+bool gradient_init(
+        Gradient *gradient, enum GRADIENTS name,
+        const Maze *maze);
+
+void gradient_free(Gradient *gradient);
+
+bool create_texture(Display *display, const Maze *maze);
+bool mipmap_init(Mipmap *mipmap, const Maze *maze);
+double mipmap_memory(int32_t rows, int32_t columns);
+void mipmap_free(Mipmap *mipmap);
+void display_free(Display *display);
+
+void viewport_pan(Viewport *view, int32_t steps_x, int32_t steps_y);
+void viewport_zoom(Viewport *view, int32_t steps);
+void viewport_fit(Viewport *view);
+
+#endif // RENDER_H
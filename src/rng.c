@@ -0,0 +1,56 @@
+#include "rng.h"
+
+// The state is filled with splitmix64, as recommended by the authors, so
+// close seeds (e.g time(NULL) of consecutive runs) give unrelated streams.
+void rng_seed(Rng *rng, uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        rng -> state[i] = z ^ (z >> 31);
+    }
+}
+
+// Same as 2^128 calls to rng_next(), streams that far apart never overlap in
+// practice.
+void rng_jump(Rng *rng)
+{
+    static const uint64_t jump[] =
+    {
+        0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+        0xa9582618e03fc9aa, 0x39abdc4529b1661c
+    };
+
+    uint64_t state[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++)
+    {
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if (jump[i] & (uint64_t)1 << bit)
+            {
+                for (int j = 0; j < 4; j++)
+                {
+                    state[j] ^= rng -> state[j];
+                }
+            }
+
+            rng_next(rng);
+        }
+    }
+
+    for (int j = 0; j < 4; j++)
+    {
+        rng -> state[j] = state[j];
+    }
+}
+
+// Hands out the current stream and jumps rng past it, splitting n times gives
+// n independent streams that only depend on the seed and the order.
+Rng rng_split(Rng *rng)
+{
+    Rng stream = *rng;
+    rng_jump(rng);
+    return stream;
+}
@@ -0,0 +1,74 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <inttypes.h>   // intN_t and uintN_t.
+
+// xoshiro256** by David Blackman and Sebastiano Vigna, https://prng.di.unimi.it
+// The whole state is explicit so every generator (or thread, or batch run)
+// draws from its own stream and the same seed always gives the same maze.
+typedef struct Rng
+{
+    uint64_t state[4];
+} Rng;
+
+void rng_seed(Rng *rng, uint64_t seed);
+void rng_jump(Rng *rng);
+Rng rng_split(Rng *rng);
+
+static inline uint64_t rng_rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t rng_next(Rng *rng)
+{
+    uint64_t *s = rng -> state;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+    return result;
+}
+
+// Uniform on [0, bound), bound must be > 0.
+// Small bounds use Lemire's multiply and shift, the few products that would
+// make it biased are rejected.
+static inline uint64_t rng_below(Rng *rng, uint64_t bound)
+{
+    if (bound <= UINT32_MAX)
+    {
+        uint64_t product = (rng_next(rng) >> 32) * bound;
+        if ((uint32_t)product < bound)
+        {
+            uint32_t threshold = (uint32_t)-bound % bound;
+            while ((uint32_t)product < threshold)
+            {
+                product = (rng_next(rng) >> 32) * bound;
+            }
+        }
+
+        return product >> 32;
+    }
+
+    uint64_t threshold = -bound % bound;
+    uint64_t value = rng_next(rng);
+    while (value < threshold)
+    {
+        value = rng_next(rng);
+    }
+
+    return value % bound;
+}
+
+static inline bool rng_bit(Rng *rng)
+{
+    return rng_next(rng) >> 63;
+}
+
+#endif // RNG_H
@@ -0,0 +1,286 @@
+#include <stdio.h>      // perror.
+#include <stdlib.h>     // malloc, realloc, free and exit.
+#include "solver.h"
+
+Tree * create_node(Arena *arena)
+{
+    Tree * node = arena_alloc(arena, sizeof(Tree));
+    if (node == NULL)
+    {
+        perror("Failed to allocate memory for node\n");
+        return NULL;
+    }
+
+    node -> parent = NULL;
+    node -> children_count = 0;
+    node -> head_x = -1;
+    node -> head_y = -1;
+    node -> parent_index = -1;
+    node -> parent_move = NONE;
+    node -> distance_runned = 0;
+    return node;
+}
+
+// Hangs a new node at x, y from node, reached through move. Exits if there's
+// no memory left for it, as move_node() does.
+Tree * add_child(
+        Tree *node, enum MAZE_MOVES move, int32_t x, int32_t y,
+        int64_t distance, Arena *arena)
+{
+    Tree *child = create_node(arena);
+    if (child == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    child -> parent_move = move;
+    child -> head_x = x;
+    child -> head_y = y;
+    child -> parent = node;
+    child -> parent_index = node -> children_count;
+    child -> distance_runned = distance;
+    node -> children[node -> children_count++] = child;
+    return child;
+}
+
+// dirty can be NULL when nothing is drawn.
+enum MOVE_STATES move_node(
+        Tree *node, Arena *arena, Maze *maze,
+        Frontier *frontier, DirtyCells *dirty)
+{
+
+    enum MAZE_MOVES moves[] = {LEFT, UP, DOWN, RIGHT};
+    size_t move_quantity = sizeof(moves) / sizeof(enum MAZE_MOVES);
+    int32_t tx, ty;
+    size_t head = maze_index(maze, node -> head_x, node -> head_y);
+    size_t target;
+
+    bool end_reached = false;
+    maze -> types[head] = DEAD_HEAD;
+    if (dirty != NULL)
+    {
+        dirty_push(dirty, head);
+    }
+
+    for (size_t move = 0; move < move_quantity; move++)
+    {
+        // Checking for out of bounds
+        if ((moves[move] == LEFT && node -> head_x <= 0) ||
+            (moves[move] == RIGHT &&
+                node -> head_x >= maze -> columns - 1) ||
+            (moves[move] == UP && node -> head_y <= 0) ||
+            (moves[move] == DOWN && node -> head_y >= maze -> rows - 1))
+        {
+            continue;
+        }
+
+        tx = node -> head_x + (moves[move] == LEFT ? -1 :
+                                moves[move] == RIGHT ? 1 : 0);
+        ty = node -> head_y + (moves[move] == UP ? -1 :
+                                moves[move] == DOWN ? 1 : 0);
+        target = maze_index(maze, tx, ty);
+
+        // Can't move to a WALL or
+        // A part where already moved to avoid infinite recursion.
+        if (maze -> types[target] != EMPTY &&
+            !(ty == maze -> end_y && tx == maze -> end_x))
+        {
+            continue;
+        }
+
+        // Succesfull move
+        // Initializing a new node
+        node -> children_count += 1;
+        node -> children[node -> children_count - 1] = create_node(arena);
+        if (node -> children[node -> children_count - 1] == NULL)
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        node -> children[node -> children_count - 1] -> parent_move = 
+            moves[move];
+
+        node -> children[node -> children_count - 1] -> head_x = tx;
+        node -> children[node -> children_count - 1] -> head_y = ty;
+
+        node -> children[node -> children_count - 1] -> parent = node;
+
+        node -> children[node -> children_count - 1] -> parent_index =
+            node -> children_count - 1;
+        
+        node -> children[node -> children_count - 1] -> distance_runned =
+            node -> distance_runned + 1;
+
+        frontier_push(frontier, node -> children[node -> children_count - 1]);
+
+        maze -> types[head] = BODY;
+        maze -> types[target] = LIVE_HEAD;
+        maze_set_distance(maze, target, node -> distance_runned + 1);
+        if (dirty != NULL)
+        {
+            dirty_push(dirty, target);
+        }
+        
+        if (ty == maze -> end_y && tx == maze -> end_x)
+        {
+            end_reached = true;
+        }
+    }
+    
+    return end_reached ? NODE_END_REACHED : node -> children_count > 0 ?
+                NODE_MOVED : NODE_CANT_MOVE;
+}
+
+// Moves each live head of the frontier once (a generation), returns true if
+// atleast one node moved.
+// The heads are kept in the same order as the leaves of the tree from left to
+// right, so the cells claimed and the winner are the same as walking the tree.
+bool forking_step(
+        Frontier *frontier, Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node)
+{
+    bool atleast_one_node_moved = false;
+    for (size_t head = 0; head < frontier -> heads_count; head++)
+    {
+        Tree *node_to_mv = frontier -> heads[head];
+        enum MOVE_STATES result = move_node(
+                node_to_mv, arena, maze, frontier, dirty);
+        if (result == NODE_END_REACHED)
+        {
+            // Do not break yet, we want each node to move or be
+            // dead on each turn.
+            *end_reached = true;
+            *winner_node = node_to_mv;
+        }
+
+        if (result == NODE_MOVED)
+        {
+            atleast_one_node_moved = true;
+        }
+    }
+
+    frontier_swap(frontier);
+    return atleast_one_node_moved;
+}
+
+bool frontier_init(Frontier *frontier, Tree *root)
+{
+    frontier -> heads_capacity = 64;
+    frontier -> next_heads_capacity = 64;
+    frontier -> heads = malloc(sizeof(Tree*) * frontier -> heads_capacity);
+    frontier -> next_heads =
+        malloc(sizeof(Tree*) * frontier -> next_heads_capacity);
+
+    if (frontier -> heads == NULL || frontier -> next_heads == NULL)
+    {
+        perror("Failed to allocate memory for frontier\n");
+        free(frontier -> heads);
+        free(frontier -> next_heads);
+        return false;
+    }
+
+    frontier -> heads[0] = root;
+    frontier -> heads_count = 1;
+    frontier -> next_heads_count = 0;
+    return true;
+}
+
+void frontier_push(Frontier *frontier, Tree *node)
+{
+    if (frontier -> next_heads_count == frontier -> next_heads_capacity)
+    {
+        frontier -> next_heads_capacity *= 2;
+        frontier -> next_heads = realloc(frontier -> next_heads,
+                sizeof(Tree*) * frontier -> next_heads_capacity);
+
+        if (frontier -> next_heads == NULL)
+        {
+            perror("Failed to allocate memory for frontier\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    frontier -> next_heads[frontier -> next_heads_count++] = node;
+}
+
+// The next generation becomes the current one and the old current buffer is
+// reused for the following generation.
+void frontier_swap(Frontier *frontier)
+{
+    Tree **heads = frontier -> heads;
+    size_t heads_capacity = frontier -> heads_capacity;
+
+    frontier -> heads = frontier -> next_heads;
+    frontier -> heads_count = frontier -> next_heads_count;
+    frontier -> heads_capacity = frontier -> next_heads_capacity;
+
+    frontier -> next_heads = heads;
+    frontier -> next_heads_count = 0;
+    frontier -> next_heads_capacity = heads_capacity;
+}
+
+void frontier_free(Frontier *frontier)
+{
+    free(frontier -> heads);
+    free(frontier -> next_heads);
+    frontier -> heads = frontier -> next_heads = NULL;
+    frontier -> heads_count = frontier -> next_heads_count = 0;
+}
+
+// Starts asking for a full repaint, nothing has been drawn yet.
+bool dirty_init(DirtyCells *dirty, size_t capacity)
+{
+    dirty -> cells = malloc(sizeof(size_t) * capacity);
+    if (dirty -> cells == NULL)
+    {
+        perror("Failed to allocate memory for dirty cells\n");
+        return false;
+    }
+
+    dirty -> count = 0;
+    dirty -> capacity = capacity;
+    dirty -> everything = true;
+    return true;
+}
+
+// Once full a repaint of everything is cheaper than remembering more cells.
+void dirty_push(DirtyCells *dirty, size_t cell)
+{
+    if (dirty -> everything)
+    {
+        return;
+    }
+
+    if (dirty -> count == dirty -> capacity)
+    {
+        dirty -> everything = true;
+        return;
+    }
+
+    dirty -> cells[dirty -> count++] = cell;
+}
+
+void dirty_clear(DirtyCells *dirty)
+{
+    dirty -> count = 0;
+    dirty -> everything = false;
+}
+
+void dirty_free(DirtyCells *dirty)
+{
+    free(dirty -> cells);
+    dirty -> cells = NULL;
+    dirty -> count = dirty -> capacity = 0;
+}
+
+// Sets the type and distance of a cell and marks it dirty, dirty can be NULL.
+void paint_cell(Maze *maze, DirtyCells *dirty, size_t cell,
+        uint8_t type, int64_t distance)
+{
+    maze -> types[cell] = type;
+    maze_set_distance(maze, cell, distance);
+    if (dirty != NULL)
+    {
+        dirty_push(dirty, cell);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include "arena.h"      // Arena, bump allocator for the nodes of the tree.
+#include "maze.h"       // Maze, flat grid and its index API.
+
+// A cell can be left through 4 moves at most (LEFT, RIGHT, DOWN, UP).
+#define MAX_MOVES 4
+
+// Nodes of the tree are allocated in blocks of this many nodes.
+#define TREE_ARENA_BLOCK_NODES 4096
+
+// Cells changed between two frames that are remembered before giving up and
+// repainting the whole maze.
+#define DIRTY_CELLS_CAPACITY 65536
+
+enum MAZE_MOVES {NONE, LEFT, RIGHT, DOWN, UP};
+
+enum MOVE_STATES {NODE_END_REACHED, NODE_MOVED, NODE_CANT_MOVE};
+
+typedef struct Tree
+{
+    int8_t parent_move;         /* Parent move that got u here */
+    int8_t parent_index;        // Idx of tree on the parent children array
+    int8_t children_count;      /* On a maze it would be 4 available moves */
+    int32_t head_x;
+    int32_t head_y;
+    int64_t distance_runned;
+    struct Tree *parent;
+    struct Tree *children[MAX_MOVES];
+} Tree;
+
+// Live heads of the tree, double buffered: move_node() pushes the children of
+// the current generation into next_heads and then both buffers are swapped,
+// dead heads are simply not pushed so they drop out.
+typedef struct Frontier
+{
+    Tree **heads;
+    size_t heads_count;
+    size_t heads_capacity;
+    Tree **next_heads;
+    size_t next_heads_count;
+    size_t next_heads_capacity;
+} Frontier;
+
+// Cells whose type changed since the last frame, filled by move_node() and the
+// winner walk so draw_maze() only repaints those.
+// everything is set when the whole maze must be repainted (first frame,
+// window resized or exposed, more changes than capacity).
+typedef struct DirtyCells
+{
+    size_t *cells;
+    size_t count;
+    size_t capacity;
+    bool everything;
+} DirtyCells;
+
+// Tree related
+Tree * create_node(Arena *arena);
+Tree * add_child(
+        Tree *node, enum MAZE_MOVES move, int32_t x, int32_t y,
+        int64_t distance, Arena *arena);
+
+bool forking_step(
+        Frontier *frontier, Arena *arena, Maze *maze, DirtyCells *dirty,
+        bool *end_reached, Tree **winner_node);
+
+enum MOVE_STATES move_node(
+        Tree *node, Arena *arena, Maze *maze,
+        Frontier *frontier, DirtyCells *dirty);
+
+// Frontier related
+bool frontier_init(Frontier *frontier, Tree *root);
+void frontier_push(Frontier *frontier, Tree *node);
+void frontier_swap(Frontier *frontier);
+void frontier_free(Frontier *frontier);
+
+// Dirty cells related
+bool dirty_init(DirtyCells *dirty, size_t capacity);
+void dirty_push(DirtyCells *dirty, size_t cell);
+void dirty_clear(DirtyCells *dirty);
+void dirty_free(DirtyCells *dirty);
+void paint_cell(Maze *maze, DirtyCells *dirty, size_t cell,
+        uint8_t type, int64_t distance);
+
+#endif // SOLVER_H
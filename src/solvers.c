@@ -0,0 +1,525 @@
+// pthread_barrier_t (from parallel-solver.h) isn't part of c99.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>     // llabs.
+#include "solvers.h"
+#include "grid-kernels.h"   // Per type counts of the solved grid.
+
+static bool init_forking(Solver *solver, Tree *root);
+static bool step_forking(Solver *solver, DirtyCells *dirty);
+static void free_forking(Solver *solver);
+static bool init_bidirectional(Solver *solver, Tree *root);
+static bool step_bidirectional(Solver *solver, DirtyCells *dirty);
+static void free_bidirectional(Solver *solver);
+static bool init_astar(Solver *solver, Tree *root);
+static bool step_astar(Solver *solver, DirtyCells *dirty);
+static void free_astar(Solver *solver);
+static bool init_jps(Solver *solver, Tree *root);
+static bool step_jps(Solver *solver, DirtyCells *dirty);
+static void free_jps(Solver *solver);
+static bool init_junctions(Solver *solver, Tree *root);
+static bool step_junctions(Solver *solver, DirtyCells *dirty);
+static void free_junctions(Solver *solver);
+static bool init_compact(Solver *solver, Tree *root);
+static bool step_compact(Solver *solver, DirtyCells *dirty);
+static void free_compact(Solver *solver);
+static bool init_bitboard(Solver *solver, Tree *root);
+static bool step_bitboard(Solver *solver, DirtyCells *dirty);
+static void free_bitboard(Solver *solver);
+static enum MAZE_MOVES move_to_parent(const Tree *node);
+
+static const SolverOps solver_ops[SOLVERS_COUNT] =
+{
+    [SOLVER_FORKING] = {init_forking, step_forking, free_forking},
+    [SOLVER_BIDIRECTIONAL] =
+        {init_bidirectional, step_bidirectional, free_bidirectional},
+    [SOLVER_ASTAR] = {init_astar, step_astar, free_astar},
+    [SOLVER_JPS] = {init_jps, step_jps, free_jps},
+    [SOLVER_JUNCTIONS] = {init_junctions, step_junctions, free_junctions},
+    [SOLVER_COMPACT] = {init_compact, step_compact, free_compact},
+    [SOLVER_BITBOARD] = {init_bitboard, step_bitboard, free_bitboard},
+};
+
+// Same names as --solver.
+const char * solver_name(enum SOLVERS solver)
+{
+    switch (solver)
+    {
+        case SOLVER_FORKING:
+            return "forking";
+
+        case SOLVER_BIDIRECTIONAL:
+            return "bidirectional";
+
+        case SOLVER_ASTAR:
+            return "astar";
+
+        case SOLVER_JPS:
+            return "jps";
+
+        case SOLVER_JUNCTIONS:
+            return "junctions";
+
+        case SOLVER_COMPACT:
+            return "compact";
+
+        case SOLVER_BITBOARD:
+            return "bitboard";
+
+        default:
+            return "unknown";
+    }
+}
+
+// Only the forking solver has a parallel step, threads are ignored otherwise.
+bool solver_init(
+        Solver *solver, enum SOLVERS kind,
+        Tree *root, Arena *arena, Maze *maze,
+        int32_t threads)
+{
+    *solver = (Solver){0};
+    solver -> ops = &solver_ops[kind];
+    solver -> kind = kind;
+    solver -> arena = arena;
+    solver -> maze = maze;
+    solver -> threads = kind == SOLVER_FORKING ? threads : 1;
+    solver -> moved = true;
+    return solver -> ops -> init(solver, root);
+}
+
+// Returns true once the solver is done, see solver_is_done().
+bool solver_step(Solver *solver, DirtyCells *dirty)
+{
+    solver -> moved = solver -> ops -> step(solver, dirty);
+    solver -> steps += 1;
+    return solver_is_done(solver);
+}
+
+// Either END was found or nothing can move anymore.
+bool solver_is_done(const Solver *solver)
+{
+    return solver -> end_reached || !solver -> moved;
+}
+
+// Starts walk on the winner path, next to END, false if it wasn't found.
+bool solver_path(const Solver *solver, PathWalk *walk)
+{
+    *walk = (PathWalk){.move = NONE, .done = !solver -> end_reached};
+    if (!solver -> end_reached)
+    {
+        return false;
+    }
+
+    if (solver -> kind == SOLVER_COMPACT)
+    {
+        walk -> parents = solver -> compact.parents;
+        walk -> x = maze_index_x(solver -> maze, solver -> compact.winner);
+        walk -> y = maze_index_y(solver -> maze, solver -> compact.winner);
+        return true;
+    }
+
+    if (solver -> kind == SOLVER_BITBOARD)
+    {
+        walk -> bitboard = &solver -> bitboard;
+        walk -> x = maze_index_x(solver -> maze, solver -> bitboard.winner);
+        walk -> y = maze_index_y(solver -> maze, solver -> bitboard.winner);
+        return true;
+    }
+
+    walk -> node = solver -> winner_node;
+    walk -> x = solver -> winner_node -> head_x;
+    walk -> y = solver -> winner_node -> head_y;
+    return true;
+}
+
+void solver_free(Solver *solver)
+{
+    solver -> ops -> free(solver);
+}
+
+// Open nodes, nodes of the tree and bytes of both. Every allocation of the
+// arenas is a node, the workers have an arena each for the nodes they create.
+void solver_measure(
+        const Solver *solver,
+        size_t *frontier, size_t *nodes, size_t *bytes)
+{
+    size_t used = solver -> arena -> bytes_used;
+    size_t reserved = solver -> arena -> bytes_reserved;
+    for (int32_t worker = 0; solver -> kind == SOLVER_FORKING &&
+            solver -> threads > 1 && worker < solver -> parallel.threads;
+            worker++)
+    {
+        used += solver -> parallel.arenas[worker].bytes_used;
+        reserved += solver -> parallel.arenas[worker].bytes_reserved;
+    }
+
+    const Frontier *heads = &solver -> frontier;
+    const Frontier *backward = &solver -> backward;
+    *frontier = heads -> heads_count + backward -> heads_count +
+        solver -> open.count + solver -> compact.heads_count +
+        solver -> bitboard.heads_count;
+    *nodes = used / sizeof(Tree);
+    *bytes = reserved + sizeof(Tree *) *
+        (heads -> heads_capacity + heads -> next_heads_capacity +
+         backward -> heads_capacity + backward -> next_heads_capacity) +
+        sizeof(HeapEntry) * solver -> open.capacity +
+        junction_graph_bytes(&solver -> graph) +
+        compact_bytes(&solver -> compact, solver -> maze) +
+        bitboard_bytes(&solver -> bitboard);
+}
+
+// Worst case bytes of the tree and the open nodes for a perfect maze of rows
+// x columns (both odd), on double since the product can overflow even 64
+// bits. Every open cell can end up being a node of the tree and open, twice
+// for the double buffered frontiers.
+double solver_memory(enum SOLVERS solver, int32_t rows, int32_t columns)
+{
+    double carved_cells = (double)(rows / 2 + 1) * (columns / 2 + 1);
+    double open_cells = 2 * carved_cells - 1;
+    if (solver == SOLVER_ASTAR || solver == SOLVER_JPS)
+    {
+        return open_cells * (sizeof(Tree) + sizeof(HeapEntry));
+    }
+
+    // Live heads never come close to every cell, a perfect maze of 4001 x
+    // 4001 peaks below 700 of them. They're budgeted as a row and a column.
+    if (solver == SOLVER_COMPACT)
+    {
+        return (double)rows * columns / 4 +
+            2 * ((double)rows + columns) * sizeof(size_t);
+    }
+
+    // Five bitsets, the lists of words are budgeted like the heads of
+    // SOLVER_COMPACT.
+    if (solver == SOLVER_BITBOARD)
+    {
+        return 5 * (double)rows * (columns / 64 + 1) * sizeof(uint64_t) +
+            2 * ((double)rows + columns) * sizeof(size_t);
+    }
+
+    // The worst case is every open cell being a vertex with 2 edges.
+    if (solver == SOLVER_JUNCTIONS)
+    {
+        return open_cells * (sizeof(Tree) + 2 * sizeof(Tree*) +
+                2 * sizeof(size_t) + 2 * sizeof(JunctionEdge));
+    }
+
+    return open_cells * sizeof(Tree) + 2 * open_cells * sizeof(Tree*);
+}
+
+// Gives the next cell of the path, false once START was given.
+bool path_walk_next(PathWalk *walk, const Maze *maze, size_t *cell)
+{
+    if (walk -> done)
+    {
+        return false;
+    }
+
+    *cell = maze_index(maze, walk -> x, walk -> y);
+    if (walk -> parents != NULL)
+    {
+        walk -> done = walk -> x == maze -> start_x &&
+            walk -> y == maze -> start_y;
+
+        walk -> move = compact_parent(walk -> parents, *cell);
+    }
+
+    else if (walk -> bitboard != NULL)
+    {
+        walk -> done = walk -> x == maze -> start_x &&
+            walk -> y == maze -> start_y;
+
+        walk -> move = bitboard_parent(walk -> bitboard, maze,
+                walk -> x, walk -> y);
+    }
+
+    else if (walk -> x == walk -> node -> head_x &&
+            walk -> y == walk -> node -> head_y)
+    {
+        Tree *node = walk -> node;
+        walk -> node = node -> parent;
+        walk -> done = walk -> node == NULL;
+        walk -> move = walk -> done ? NONE : move_to_parent(node);
+    }
+
+    else
+    {
+        walk -> move = junction_turn(maze, walk -> x, walk -> y, walk -> move);
+    }
+
+    if (!walk -> done)
+    {
+        walk -> x += walk -> move == LEFT ? -1 : walk -> move == RIGHT ? 1 : 0;
+        walk -> y += walk -> move == UP ? -1 : walk -> move == DOWN ? 1 : 0;
+    }
+
+    return true;
+}
+
+// Same solving as find_path() but without rendering, input nor frame pacing
+// the winner path is marked entirely as soon as the end is reached.
+bool find_path_headless(
+        enum SOLVERS kind,
+        Tree *root, Arena *arena, Maze *maze,
+        int32_t threads, int64_t *generations)
+{
+    Solver solver;
+    if (!solver_init(&solver, kind, root, arena, maze, threads))
+    {
+        return false;
+    }
+
+    while (!solver_step(&solver, NULL))
+    {
+    }
+
+    *generations += solver.steps;
+
+    PathWalk walk;
+    size_t cell;
+    solver_path(&solver, &walk);
+    while (path_walk_next(&walk, maze, &cell))
+    {
+        maze -> types[cell] = WIN_BLOCK;
+    }
+
+    solver_free(&solver);
+    return solver.end_reached;
+}
+
+// Adds the cells of the trees and their heads to the counts, distance_runned
+// is the one of END once it's reached (the length of the path) or else the
+// highest of the grid, if it's above the one given.
+void nodes_info(
+        const Maze *maze,
+        int64_t *total, int64_t *live_head, int64_t *dead_head,
+        int64_t *distance_runned)
+{
+    size_t counts[GRID_TYPES];
+    size_t cells = maze_cells(maze);
+    grid_count(maze -> types, cells, counts);
+    *total += cells - counts[EMPTY] - counts[WALL] - counts[END];
+    *dead_head += counts[DEAD_HEAD] + counts[END_DEAD_HEAD];
+    *live_head += counts[LIVE_HEAD] + counts[END_LIVE_HEAD];
+
+    // Every cell that is part of a tree. END is left out while it keeps its
+    // tag, no tree reached it: forking retags it LIVE_HEAD when it arrives and
+    // the tree from END of bidirectional retags it on its first move.
+    uint16_t tree_types = (uint16_t)~(1 << EMPTY | 1 << WALL | 1 << END);
+
+    // Solvers that move more than a cell per generation (a corridor for
+    // junctions, a jump for jps) paint cells farther than END before or while
+    // reaching it, so the highest of the grid can be above the path.
+    uint32_t distance = maze -> distances_runned[maze_index(maze,
+            maze -> end_x, maze -> end_y)];
+
+    if (distance == 0)
+    {
+        distance = grid_max_distance(maze -> types,
+                maze -> distances_runned, cells, tree_types);
+    }
+
+    if (distance >= *distance_runned)
+    {
+        *distance_runned = distance;
+    }
+}
+
+static bool init_forking(Solver *solver, Tree *root)
+{
+    if (!frontier_init(&solver -> frontier, root))
+    {
+        return false;
+    }
+
+    if (solver -> threads > 1 &&
+            !parallel_solver_init(&solver -> parallel, solver -> threads))
+    {
+        frontier_free(&solver -> frontier);
+        return false;
+    }
+
+    return true;
+}
+
+static bool step_forking(Solver *solver, DirtyCells *dirty)
+{
+    return solver -> threads > 1 ?
+        parallel_solver_step(&solver -> parallel, &solver -> frontier,
+                solver -> arena, solver -> maze, dirty,
+                &solver -> end_reached, &solver -> winner_node) :
+        forking_step(&solver -> frontier, solver -> arena, solver -> maze,
+                dirty, &solver -> end_reached, &solver -> winner_node);
+}
+
+static void free_forking(Solver *solver)
+{
+    if (solver -> threads > 1)
+    {
+        parallel_solver_free(&solver -> parallel);
+    }
+
+    frontier_free(&solver -> frontier);
+}
+
+static bool init_bidirectional(Solver *solver, Tree *root)
+{
+    if (!frontier_init(&solver -> frontier, root))
+    {
+        return false;
+    }
+
+    if (!bidirectional_init(&solver -> backward,
+                solver -> arena, solver -> maze))
+    {
+        frontier_free(&solver -> frontier);
+        return false;
+    }
+
+    return true;
+}
+
+static bool step_bidirectional(Solver *solver, DirtyCells *dirty)
+{
+    return bidirectional_step(&solver -> frontier, &solver -> backward,
+            solver -> arena, solver -> maze, dirty,
+            &solver -> end_reached, &solver -> winner_node);
+}
+
+static void free_bidirectional(Solver *solver)
+{
+    frontier_free(&solver -> frontier);
+    frontier_free(&solver -> backward);
+}
+
+// The frontier only collects the children made by move_node().
+static bool init_astar(Solver *solver, Tree *root)
+{
+    if (!frontier_init(&solver -> frontier, root))
+    {
+        return false;
+    }
+
+    if (!best_first_init(&solver -> open, root, solver -> maze))
+    {
+        frontier_free(&solver -> frontier);
+        return false;
+    }
+
+    return true;
+}
+
+static bool step_astar(Solver *solver, DirtyCells *dirty)
+{
+    return astar_step(&solver -> open, &solver -> frontier,
+            solver -> arena, solver -> maze, dirty,
+            &solver -> end_reached, &solver -> winner_node);
+}
+
+static void free_astar(Solver *solver)
+{
+    frontier_free(&solver -> frontier);
+    heap_free(&solver -> open);
+}
+
+static bool init_jps(Solver *solver, Tree *root)
+{
+    return best_first_init(&solver -> open, root, solver -> maze);
+}
+
+static bool step_jps(Solver *solver, DirtyCells *dirty)
+{
+    return jps_step(&solver -> open,
+            solver -> arena, solver -> maze, dirty,
+            &solver -> end_reached, &solver -> winner_node);
+}
+
+static void free_jps(Solver *solver)
+{
+    heap_free(&solver -> open);
+}
+
+static bool init_junctions(Solver *solver, Tree *root)
+{
+    if (!junction_graph_build(&solver -> graph, solver -> maze))
+    {
+        return false;
+    }
+
+    if (!frontier_init(&solver -> frontier, root))
+    {
+        junction_graph_free(&solver -> graph);
+        return false;
+    }
+
+    return true;
+}
+
+static bool step_junctions(Solver *solver, DirtyCells *dirty)
+{
+    return junction_step(&solver -> graph, &solver -> frontier,
+            solver -> arena, solver -> maze, dirty,
+            &solver -> end_reached, &solver -> winner_node);
+}
+
+static void free_junctions(Solver *solver)
+{
+    frontier_free(&solver -> frontier);
+    junction_graph_free(&solver -> graph);
+}
+
+// The root only gives START, the heads are cells.
+static bool init_compact(Solver *solver, Tree *root)
+{
+    (void)root;
+    return compact_init(&solver -> compact, solver -> maze);
+}
+
+static bool step_compact(Solver *solver, DirtyCells *dirty)
+{
+    return compact_step(&solver -> compact, solver -> maze, dirty,
+            &solver -> end_reached);
+}
+
+static void free_compact(Solver *solver)
+{
+    compact_free(&solver -> compact);
+}
+
+// Same as SOLVER_COMPACT, the root only gives START.
+static bool init_bitboard(Solver *solver, Tree *root)
+{
+    (void)root;
+    return bitboard_init(&solver -> bitboard, solver -> maze);
+}
+
+static bool step_bitboard(Solver *solver, DirtyCells *dirty)
+{
+    return bitboard_step(&solver -> bitboard, solver -> maze, dirty,
+            &solver -> end_reached);
+}
+
+static void free_bitboard(Solver *solver)
+{
+    bitboard_free(&solver -> bitboard);
+}
+
+// First step from node towards its parent. The halves joined by the
+// bidirectional solver don't keep parent_move, but their nodes touch.
+static enum MAZE_MOVES move_to_parent(const Tree *node)
+{
+    int32_t dx = node -> parent -> head_x - node -> head_x;
+    int32_t dy = node -> parent -> head_y - node -> head_y;
+    if (llabs((int64_t)dx) + llabs((int64_t)dy) == 1)
+    {
+        return dx < 0 ? LEFT : dx > 0 ? RIGHT : dy < 0 ? UP : DOWN;
+    }
+
+    switch (node -> parent_move)
+    {
+        case LEFT: return RIGHT;
+        case RIGHT: return LEFT;
+        case UP: return DOWN;
+        default: return UP;
+    }
+}
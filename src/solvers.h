@@ -0,0 +1,112 @@
+#ifndef SOLVERS_H
+#define SOLVERS_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include "arena.h"      // Arena, bump allocator for the nodes of the tree.
+#include "maze.h"       // Maze, flat grid and its index API.
+#include "solver.h"     // Tree, Frontier, DirtyCells and move_node().
+#include "parallel-solver.h"    // Generations split across threads.
+#include "bidirectional.h"      // Second tree grown from END.
+#include "heap.h"       // NodeHeap, open nodes by cost.
+#include "astar.h"      // A* and jump point search.
+#include "junctions.h"   // Corridors contracted into edges.
+#include "compact.h"    // Parents in 2 bits per cell instead of nodes.
+#include "bitboard.h"   // Frontier as bitsets of 64 cells a word.
+
+enum SOLVERS
+{
+    SOLVER_FORKING,         // A tree from START, forks on every junction.
+    SOLVER_BIDIRECTIONAL,   // Trees from START and END until they touch.
+    SOLVER_ASTAR,           // Best first by distance plus manhattan to END.
+    SOLVER_JPS,             // A* that only makes nodes on turns and forks.
+    SOLVER_JUNCTIONS,       // Forking over a graph of junctions and dead ends.
+    SOLVER_COMPACT,         // Forking without nodes, for huge mazes.
+    SOLVER_BITBOARD,        // Forking on bitsets, a word of cells at once.
+    SOLVERS_COUNT
+};
+
+struct Solver;
+
+// What makes each strategy, the rest of the Solver API is shared:
+//  - init: sets up the state of the strategy from the root at START.
+//  - step: moves once (a generation or so), returns true if anything moved
+//          and sets end_reached and winner_node once END is found.
+//  - free: releases what init made, not the nodes (they're on the arena).
+typedef struct SolverOps
+{
+    bool (*init)(struct Solver *solver, Tree *root);
+    bool (*step)(struct Solver *solver, DirtyCells *dirty);
+    void (*free)(struct Solver *solver);
+} SolverOps;
+
+// A strategy stepped by the engine or by find_path_headless(), the same maze
+// can be given to any of them. The state of every strategy is here and each
+// uses only its own, like Engine does.
+typedef struct Solver
+{
+    const SolverOps *ops;
+    enum SOLVERS kind;
+    Arena *arena;
+    Maze *maze;
+    int32_t threads;            // Only the forking solver uses them.
+    int64_t steps;
+    bool moved;                 // By the last step, done if not.
+    bool end_reached;
+    Tree *winner_node;          // Where the walk of the path starts.
+
+    Frontier frontier;          // Heads, or children for SOLVER_ASTAR.
+    Frontier backward;          // SOLVER_BIDIRECTIONAL.
+    ParallelSolver parallel;    // SOLVER_FORKING with threads > 1.
+    NodeHeap open;              // SOLVER_ASTAR and SOLVER_JPS.
+    JunctionGraph graph;        // SOLVER_JUNCTIONS.
+    CompactSolver compact;      // SOLVER_COMPACT, no nodes but the root.
+    BitboardSolver bitboard;    // SOLVER_BITBOARD, no nodes but the root.
+} Solver;
+
+// Walks the winner path a cell per call, from solver_path() to START. Nodes
+// can be several cells apart, on a row or column (jump point search) or along
+// a corridor (junction graph), the walk leaves a node through the opposite of
+// its parent_move and then follows the open cells.
+// Without nodes (SOLVER_COMPACT) every cell gives the move to its parent,
+// or the levels of the cells lead to it (SOLVER_BITBOARD).
+typedef struct PathWalk
+{
+    Tree *node;                 // Next node to reach.
+    const uint8_t *parents;     // Packed moves, see compact_parent().
+    const BitboardSolver *bitboard;     // See bitboard_parent().
+    int32_t x, y;
+    enum MAZE_MOVES move;       // Of the last step.
+    bool done;                  // START was given.
+} PathWalk;
+
+const char * solver_name(enum SOLVERS solver);
+bool solver_init(
+        Solver *solver, enum SOLVERS kind,
+        Tree *root, Arena *arena, Maze *maze,
+        int32_t threads);
+
+bool solver_step(Solver *solver, DirtyCells *dirty);
+bool solver_is_done(const Solver *solver);
+bool solver_path(const Solver *solver, PathWalk *walk);
+void solver_free(Solver *solver);
+void solver_measure(
+        const Solver *solver,
+        size_t *frontier, size_t *nodes, size_t *bytes);
+
+double solver_memory(enum SOLVERS solver, int32_t rows, int32_t columns);
+
+bool path_walk_next(PathWalk *walk, const Maze *maze, size_t *cell);
+
+void nodes_info(
+        const Maze *maze,
+        int64_t *total, int64_t *live, int64_t *dead,
+        int64_t *distance_runned);
+
+bool find_path_headless(
+        enum SOLVERS solver,
+        Tree *root, Arena *arena, Maze *maze,
+        int32_t threads, int64_t *generations);
+
+#endif // SOLVERS_H
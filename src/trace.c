@@ -0,0 +1,125 @@
+// pthread_barrier_t (from parallel-solver.h) isn't part of c99.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>      // fopen, fprintf and perror.
+#include "trace.h"
+
+// Frames taken from the ring at once, written without holding the lock.
+#define TRACE_BATCH_FRAMES 256
+
+static void * trace_loop(void *data);
+static void write_frame(FILE *file, const FrameStats *stats);
+
+bool trace_open(Trace *trace, const char *path)
+{
+    trace -> file = fopen(path, "w");
+    if (trace -> file == NULL)
+    {
+        perror("Failed to open trace file\n");
+        return false;
+    }
+
+    fprintf(trace -> file, "frame,time_ms,frame_ms,solve_ms,walk_ms,"
+            "publish_ms,draw_ms,present_ms,steps,frontier,nodes,bytes\n");
+
+    trace -> first = 0;
+    trace -> count = 0;
+    trace -> dropped = 0;
+    trace -> quit = false;
+    pthread_mutex_init(&trace -> lock, NULL);
+    pthread_cond_init(&trace -> wake, NULL);
+    if (pthread_create(&trace -> thread, NULL, trace_loop, trace) != 0)
+    {
+        perror("Failed to create trace thread\n");
+        pthread_cond_destroy(&trace -> wake);
+        pthread_mutex_destroy(&trace -> lock);
+        fclose(trace -> file);
+        return false;
+    }
+
+    return true;
+}
+
+// Never waits for the writer, the frame is dropped if the ring is full.
+void trace_push(Trace *trace, const FrameStats *stats)
+{
+    pthread_mutex_lock(&trace -> lock);
+    if (trace -> count == TRACE_RING_FRAMES)
+    {
+        trace -> dropped += 1;
+    }
+
+    else
+    {
+        size_t last = (trace -> first + trace -> count) % TRACE_RING_FRAMES;
+        trace -> frames[last] = *stats;
+        trace -> count += 1;
+        pthread_cond_signal(&trace -> wake);
+    }
+
+    pthread_mutex_unlock(&trace -> lock);
+}
+
+// Writes the frames left and closes the file, returns the frames dropped.
+int64_t trace_close(Trace *trace)
+{
+    pthread_mutex_lock(&trace -> lock);
+    trace -> quit = true;
+    pthread_cond_signal(&trace -> wake);
+    pthread_mutex_unlock(&trace -> lock);
+    pthread_join(trace -> thread, NULL);
+
+    pthread_cond_destroy(&trace -> wake);
+    pthread_mutex_destroy(&trace -> lock);
+    if (fclose(trace -> file) != 0)
+    {
+        perror("Failed to write trace file\n");
+    }
+
+    return trace -> dropped;
+}
+
+static void * trace_loop(void *data)
+{
+    Trace *trace = data;
+    FrameStats batch[TRACE_BATCH_FRAMES];
+    while (true)
+    {
+        pthread_mutex_lock(&trace -> lock);
+        while (!trace -> quit && trace -> count == 0)
+        {
+            pthread_cond_wait(&trace -> wake, &trace -> lock);
+        }
+
+        if (trace -> count == 0)
+        {
+            pthread_mutex_unlock(&trace -> lock);
+            return NULL;
+        }
+
+        size_t taken = 0;
+        while (taken < TRACE_BATCH_FRAMES && trace -> count > 0)
+        {
+            batch[taken++] = trace -> frames[trace -> first];
+            trace -> first = (trace -> first + 1) % TRACE_RING_FRAMES;
+            trace -> count -= 1;
+        }
+
+        pthread_mutex_unlock(&trace -> lock);
+        for (size_t i = 0; i < taken; i++)
+        {
+            write_frame(trace -> file, &batch[i]);
+        }
+    }
+}
+
+static void write_frame(FILE *file, const FrameStats *stats)
+{
+    const EngineStats *engine = &stats -> engine;
+    fprintf(file, "%"PRId64",%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,"
+            "%"PRId64",%zu,%zu,%zu\n",
+            stats -> frame, stats -> time_ms, stats -> frame_ms,
+            engine -> solve_ms, engine -> walk_ms, engine -> publish_ms,
+            stats -> draw_ms, stats -> present_ms, engine -> steps,
+            engine -> frontier, engine -> nodes, engine -> bytes);
+}
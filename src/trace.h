@@ -0,0 +1,47 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>    // bool, true and false macros.
+#include <stddef.h>     // size_t.
+#include <inttypes.h>   // intN_t and uintN_t.
+#include <stdio.h>      // FILE.
+#include <pthread.h>    // pthread_t, pthread_mutex_t and pthread_cond_t.
+#include "engine.h"     // EngineStats, what the solver did on a frame.
+
+// Frames waiting to be written, the frame loop drops frames instead of
+// waiting for the disk when it's full.
+#define TRACE_RING_FRAMES 4096
+
+// Where the time of a frame went, also shown on the HUD.
+typedef struct FrameStats
+{
+    int64_t frame;
+    double time_ms;                 // Since the first frame.
+    double frame_ms;                // Without the wait for the next frame.
+    double draw_ms;                 // draw_maze().
+    double present_ms;              // SDL_RenderPresent().
+    EngineStats engine;
+} FrameStats;
+
+// Writes the frames as CSV on its own thread, the frame loop only copies them
+// into the ring.
+typedef struct Trace
+{
+    FILE *file;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+
+    // Guarded by lock.
+    FrameStats frames[TRACE_RING_FRAMES];
+    size_t first;
+    size_t count;
+    int64_t dropped;
+    bool quit;
+} Trace;
+
+bool trace_open(Trace *trace, const char *path);
+void trace_push(Trace *trace, const FrameStats *stats);
+int64_t trace_close(Trace *trace);
+
+#endif // TRACE_H
@@ -0,0 +1,41 @@
+#!/bin/sh
+# Generates mazes with every generator over several seeds and sizes (odd,
+# even and degenerate ones) and fails if any of them isn't a perfect maze,
+# as checked by --verify.
+# e.g ./tests/check-generators.sh ./maze-visualizer
+
+PROGRAM=${1:-./maze-visualizer}
+GENERATORS="backtracker kruskal wilson eller"
+SEEDS="1 2 3 4 5"
+
+# rows x columns.
+SIZES="1x1 1x2 2x1 1x63 63x1 2x64 64x2 3x3 4x4 31x31 32x48 33x64 64x33
+127x255"
+
+checked=0
+failed=0
+for generator in $GENERATORS
+do
+    for seed in $SEEDS
+    do
+        for size in $SIZES
+        do
+            rows=${size%x*}
+            columns=${size#*x}
+            checked=$((checked + 1))
+            output=$("$PROGRAM" --headless --verify --generator="$generator" \
+                --seed="$seed" --maze_rows="$rows" --maze_columns="$columns" \
+                2>&1)
+
+            if [ $? -ne 0 ] || ! echo "$output" | grep -q "^Perfect: *yes"
+            then
+                failed=$((failed + 1))
+                echo "FAIL: $generator seed $seed ${rows}x${columns}"
+                echo "$output" | sed 's/^/    /'
+            fi
+        done
+    done
+done
+
+echo "$((checked - failed)) of $checked mazes are perfect"
+[ $failed -eq 0 ]
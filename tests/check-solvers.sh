@@ -0,0 +1,53 @@
+#!/bin/sh
+# Solves the same mazes with every solver and fails if the Distance any of
+# them reports isn't the one of forking: on a perfect maze it's the length of
+# the only path from START to END.
+# e.g ./tests/check-solvers.sh ./maze-visualizer
+
+PROGRAM=${1:-./maze-visualizer}
+SOLVERS="bidirectional astar jps junctions compact bitboard"
+GENERATORS="backtracker kruskal"
+SEEDS="2 5"
+
+# rows x columns.
+SIZES="1x9 9x1 65x129 301x301"
+
+distance()
+{
+    "$PROGRAM" --headless --generator="$1" --seed="$2" \
+        --maze_rows="$3" --maze_columns="$4" --solver="$5" 2>&1 |
+        sed -n 's/^Distance: *//p'
+}
+
+checked=0
+failed=0
+for generator in $GENERATORS
+do
+    for seed in $SEEDS
+    do
+        for size in $SIZES
+        do
+            rows=${size%x*}
+            columns=${size#*x}
+            expected=$(distance "$generator" "$seed" "$rows" "$columns" \
+                forking)
+
+            for solver in $SOLVERS
+            do
+                checked=$((checked + 1))
+                got=$(distance "$generator" "$seed" "$rows" "$columns" \
+                    "$solver")
+
+                if [ -z "$expected" ] || [ "$got" != "$expected" ]
+                then
+                    failed=$((failed + 1))
+                    echo "FAIL: $solver $generator seed $seed" \
+                        "${rows}x${columns}: Distance $got, forking $expected"
+                fi
+            done
+        done
+    done
+done
+
+echo "$((checked - failed)) of $checked solves match the forking Distance"
+[ $failed -eq 0 ]